@@ -8,9 +8,41 @@
 
 #include <stddef.h>
 
+/* Every new block is twice as large as the previous one, starting at
+ * aa_BLOCK_SIZE and capped at aa_BLOCK_MAX bytes. Allocations larger than a
+ * quarter of the next block get a dedicated block, which is freed again on
+ * aa_dealloc. */
 #ifndef aa_BLOCK_SIZE
 #define aa_BLOCK_SIZE (16*1024)
 #endif
+#ifndef aa_BLOCK_MAX
+#define aa_BLOCK_MAX (64*1024*1024)
+#endif
+
+/* Defining aa_STATS adds an aa_Stats member to aa_Arena, which needs to be
+ * consistent across translation units. requested, padding and tail_waste
+ * (unused space left at the end of a block when moving on to the next one)
+ * are reset by aa_dealloc and restored by aa_rewind, peak is the high-water
+ * mark of their sum across all cycles. reserved counts the bytes currently
+ * held in blocks or committed by the vmem backend, including the block
+ * headers. hist[i] counts the allocations of sizes in [2^(i-1),2^i). */
+#ifdef aa_STATS
+#include <stdio.h>
+#include <limits.h>
+
+typedef struct {
+	size_t requested, padding, tail_waste, peak;
+	size_t reserved, blocks, large_blocks;
+	size_t allocs, deallocs;
+	size_t hist[sizeof(size_t) * CHAR_BIT + 1];
+} aa_Stats;
+#endif
+
+/* see aa_concurrent_reserve */
+typedef struct aa_ConcurrentArena {
+	unsigned char *base;
+	size_t size, used, slab_size;
+} aa_ConcurrentArena;
 
 typedef struct {
 	/* blocks       current
@@ -18,12 +50,119 @@ typedef struct {
 	*  {:} -> {:} -> {.} -> { } -> 0 */
 	struct aa_Block *blocks;
 	struct aa_Block *current;
+	/* dedicated blocks for oversized allocations */
+	struct aa_Block *large;
+	/* end of the reserved address range, if created with aa_init_vmem */
+	unsigned char *reserve_end;
+	size_t commit_size;
+	/* the shared arena, if created with aa_init_concurrent */
+	aa_ConcurrentArena *shared;
+#ifdef aa_STATS
+	aa_Stats stats;
+#endif
 } aa_Arena;
 
+/* aa_alloc aligns to the largest power of two dividing size, but at most to
+ * the alignment of max_align_t, since that's all an object of the given size
+ * could require. aa_alloc_aligned supports any power of two alignment and
+ * aa_alloc_packed doesn't align at all. */
 extern void *aa_alloc(aa_Arena *arena, size_t size);
+extern void *aa_alloc_aligned(aa_Arena *arena, size_t size, size_t align);
+extern void *aa_alloc_packed(aa_Arena *arena, size_t size);
+/* Resizes an allocation of old bytes in place if it's the last one in the
+ * current block and moves it otherwise. Unlike aa_alloc, a size of 0 returns 0,
+ * and releases the allocation if it was the last one. */
+extern void *aa_realloc(aa_Arena *arena, void *ptr, size_t old, size_t size);
 extern void aa_dealloc(aa_Arena *arena);
 extern void aa_free(aa_Arena *arena);
 
+/* Instead of allocating blocks with malloc, aa_init_vmem reserves reserve
+ * bytes of address space once and commits it in multiples of aa_VMEM_COMMIT as
+ * needed. All allocations are contiguous, aa_alloc fails once the reservation
+ * is exhausted, and aa_dealloc returns all but the first aa_VMEM_COMMIT bytes
+ * to the OS without unmapping them.
+ * With aa_HUGEPAGES transparent huge pages are requested for the range, with
+ * aa_HUGETLB it's mapped from the preallocated huge page pool.
+ * The arena must be empty, returns 0 on failure or if the OS doesn't support
+ * it. */
+#ifndef aa_VMEM_COMMIT
+#define aa_VMEM_COMMIT (2*1024*1024)
+#endif
+#define aa_HUGEPAGES 1
+#define aa_HUGETLB 2
+extern int aa_init_vmem(aa_Arena *arena, size_t reserve, int flags);
+
+/* aa_ConcurrentArena is a vmem reservation shared between threads. Every
+ * thread allocates from its own aa_Arena created with aa_init_concurrent,
+ * which grabs slab_size slabs from the shared one with a single atomic
+ * fetch-add and otherwise doesn't synchronize at all.
+ * The memory stays owned by the shared arena: aa_dealloc and aa_rewind only
+ * allow the calling thread to reuse its slabs, oversized allocations are never
+ * reclaimed, and aa_free just detaches the thread local arena.
+ * aa_concurrent_free releases everything at once, after which the thread local
+ * arenas mustn't be used anymore.
+ * aa_concurrent_reserve returns 0 on failure or if the OS doesn't support
+ * it. */
+extern int aa_concurrent_reserve(aa_ConcurrentArena *shared, size_t reserve,
+                                 size_t slab_size, int flags);
+extern void aa_concurrent_free(aa_ConcurrentArena *shared);
+extern void aa_init_concurrent(aa_Arena *arena, aa_ConcurrentArena *shared);
+
+/* aa_rewind deallocates everything allocated after the corresponding
+ * aa_mark, marks can be nested like a stack. */
+typedef struct {
+	struct aa_Block *block, *large;
+	unsigned char *ptr;
+#ifdef aa_STATS
+	size_t requested, padding, tail_waste;
+#endif
+} aa_Mark;
+
+extern aa_Mark aa_mark(aa_Arena *arena);
+extern void aa_rewind(aa_Arena *arena, aa_Mark mark);
+
+#ifdef aa_STATS
+extern void aa_stats_print(aa_Arena const *arena, FILE *f);
+#endif
+
+/* aa_Pool hands out fixed size slots from an arena, which can be individually
+ * returned to the pool with aa_pool_dealloc and are kept in an intrusive free
+ * list. Slots are at least as large as a pointer, align=0 selects the same
+ * alignment aa_alloc would use. Deallocating or freeing the underlying arena
+ * invalidates the pool, so it needs to be reinitialized afterwards. */
+typedef struct {
+	aa_Arena *arena;
+	void *free;
+	size_t size, align;
+	int lock;
+} aa_Pool;
+
+extern void aa_pool_init(aa_Pool *pool, aa_Arena *arena,
+                         size_t size, size_t align);
+extern void *aa_pool_alloc(aa_Pool *pool);
+extern void aa_pool_dealloc(aa_Pool *pool, void *ptr);
+
+/* aa_PoolCache is a thread local cache of up to 2*aa_POOL_CACHE free slots,
+ * which are exchanged with the shared pool in batches of aa_POOL_CACHE while
+ * holding a spin lock. The pool mustn't be used directly while caches are
+ * active, and aa_pool_cache_flush returns all cached slots to the pool. */
+#if defined(__GNUC__) || defined(__clang__)
+#ifndef aa_POOL_CACHE
+#define aa_POOL_CACHE 64
+#endif
+
+typedef struct {
+	aa_Pool *pool;
+	void *free;
+	size_t count;
+} aa_PoolCache;
+
+extern void aa_pool_cache_init(aa_PoolCache *cache, aa_Pool *pool);
+extern void *aa_pool_cache_alloc(aa_PoolCache *cache);
+extern void aa_pool_cache_dealloc(aa_PoolCache *cache, void *ptr);
+extern void aa_pool_cache_flush(aa_PoolCache *cache);
+#endif
+
 
 #define ARENA_ALLOCATOR_H_INCLUDED
 #endif
@@ -34,6 +173,7 @@ extern void aa_free(aa_Arena *arena);
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 struct aa_Block {
 	struct aa_Block *next;
@@ -58,44 +198,400 @@ struct aa_Block {
 # define aa_MAX_ALIGN sizeof(union aa_MaxAlign)
 #endif
 
-void *
-aa_alloc(aa_Arena *arena, size_t size)
+/* padding needed to align p to a */
+#define aa_PAD(p, a) ((0u - (size_t)(p)) & ((a) - 1))
+
+#ifdef aa_STATS
+# define aa__STATS(x) (x)
+
+static void
+aa__stats_alloc(aa_Arena *arena, size_t size, size_t pad)
+{
+	aa_Stats *s = &arena->stats;
+	size_t i, n, use;
+	for (i = 0, n = size; n; n >>= 1)
+		++i;
+	++s->hist[i];
+	++s->allocs;
+	s->requested += size;
+	s->padding += pad;
+	use = s->requested + s->padding + s->tail_waste;
+	if (use > s->peak)
+		s->peak = use;
+}
+
+/* undoes the counts of an allocation released by aa_realloc, its padding
+ * stays, since the block pointer is only reset to the allocation itself */
+static void
+aa__stats_release(aa_Arena *arena, size_t size)
+{
+	aa_Stats *s = &arena->stats;
+	size_t i, n;
+	for (i = 0, n = size; n; n >>= 1)
+		++i;
+	--s->hist[i];
+	--s->allocs;
+	s->requested -= size;
+}
+
+void
+aa_stats_print(aa_Arena const *arena, FILE *f)
 {
-#define aa_ALIGN_UP(x, n) (((x) + (n) - 1) & ~((n) - 1))
+	aa_Stats const *s = &arena->stats;
+	size_t i;
+	fprintf(f, "requested:  %lu\n", (unsigned long)s->requested);
+	fprintf(f, "padding:    %lu\n", (unsigned long)s->padding);
+	fprintf(f, "tail waste: %lu\n", (unsigned long)s->tail_waste);
+	fprintf(f, "peak:       %lu\n", (unsigned long)s->peak);
+	fprintf(f, "reserved:   %lu\n", (unsigned long)s->reserved);
+	fprintf(f, "blocks:     %lu (+%lu oversized)\n",
+	        (unsigned long)s->blocks, (unsigned long)s->large_blocks);
+	fprintf(f, "allocs:     %lu in %lu cycles\n",
+	        (unsigned long)s->allocs, (unsigned long)s->deallocs + 1);
+	for (i = 0; i < sizeof s->hist / sizeof *s->hist; ++i)
+		if (s->hist[i])
+			fprintf(f, "  <= %-20.0f %lu\n",
+			        i ? (double)((size_t)1 << (i - 1)) * 2 - 1 : 0.0,
+			        (unsigned long)s->hist[i]);
+}
+#else
+# define aa__STATS(x) ((void)0)
+#endif
 
-	struct aa_Block *it, *prev;
-	size_t old = size;
+#if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+# include <sys/mman.h>
+# if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#  define MAP_ANONYMOUS MAP_ANON
+# endif
+#endif
 
-	size = aa_ALIGN_UP(size, aa_MAX_ALIGN);
-	it = prev = arena->current;
+/* MAP_ANONYMOUS isn't available with e.g. -std=c89 on glibc, unless a feature
+ * test macro like _DEFAULT_SOURCE is defined */
+#ifdef MAP_ANONYMOUS
 
-	/* find the first block with enough space */
-	assert(it ? it->end >= it->ptr : 1);
-	while (it && size > (size_t)(it->end - it->ptr))
-		prev = it, it = it->next;
+/* reserve must be a multiple of aa_VMEM_COMMIT */
+static unsigned char *
+aa__reserve(size_t reserve, int flags)
+{
+	int mflags = MAP_PRIVATE | MAP_ANONYMOUS;
+	size_t c = aa_VMEM_COMMIT, n;
+	unsigned char *p, *q;
 
-	if (it) {
-		/* size fits in a block */
-		arena->current = it;
-		it->ptr += size;
+	if (flags & aa_HUGETLB) {
+#ifdef MAP_HUGETLB
+		mflags |= MAP_HUGETLB;
+#else
+		return 0;
+#endif
+	}
+#ifdef MAP_NORESERVE
+	mflags |= MAP_NORESERVE;
+#endif
+
+	/* over-reserve to align the range to aa_VMEM_COMMIT, which allows the
+	 * kernel to back it with huge pages */
+	n = flags & aa_HUGETLB ? reserve : reserve + c;
+	p = (unsigned char *)mmap(0, n, PROT_NONE, mflags, -1, 0);
+	if (p == (unsigned char *)MAP_FAILED)
+		return 0;
+	if (!(flags & aa_HUGETLB)) {
+		q = p + aa_PAD(p, c);
+		if (q != p)
+			munmap(p, (size_t)(q - p));
+		if (q + reserve != p + n)
+			munmap(q + reserve, (size_t)(p + n - (q + reserve)));
+		p = q;
+	}
+
+#ifdef MADV_HUGEPAGE
+	if (flags & aa_HUGEPAGES)
+		madvise(p, reserve, MADV_HUGEPAGE);
+#endif
+	return p;
+}
+
+int
+aa_init_vmem(aa_Arena *arena, size_t reserve, int flags)
+{
+	size_t c = aa_VMEM_COMMIT;
+	unsigned char *p;
+	struct aa_Block *b;
+
+	arena->blocks = arena->current = arena->large = 0;
+	arena->shared = 0;
+	arena->reserve_end = 0;
+	reserve = (reserve + c - 1) & ~(c - 1);
+	if (!(p = aa__reserve(reserve, flags)))
+		return 0;
+
+	if (mprotect(p, c, PROT_READ | PROT_WRITE) != 0) {
+		munmap(p, reserve);
+		return 0;
+	}
+
+	b = (struct aa_Block *)p;
+	b->next = 0;
+	b->first = b->ptr = (unsigned char *)(b + 1);
+	b->end = p + c;
+	arena->blocks = arena->current = b;
+	arena->reserve_end = p + reserve;
+	arena->commit_size = c;
+	aa__STATS(memset(&arena->stats, 0, sizeof arena->stats));
+	aa__STATS(arena->stats.reserved = c);
+	aa__STATS(arena->stats.blocks = 1);
+	return 1;
+}
+
+static void *
+aa__vmem_alloc(aa_Arena *arena, size_t size, size_t align)
+{
+	struct aa_Block *b = arena->current;
+	unsigned char *p = b->ptr + aa_PAD(b->ptr, align);
+	size_t n;
+
+	if (p > arena->reserve_end || size > (size_t)(arena->reserve_end - p))
+		return 0;
+	/* commit enough to fit the allocation */
+	n = (size_t)(p + size - b->end);
+	n = (n + arena->commit_size - 1) & ~(arena->commit_size - 1);
+	if (mprotect(b->end, n, PROT_READ | PROT_WRITE) != 0)
+		return 0;
+	aa__STATS(arena->stats.reserved += n);
+	aa__STATS(aa__stats_alloc(arena, size, (size_t)(p - b->ptr)));
+	b->end += n;
+	b->ptr = p + size;
+	return p;
+}
+
+static void
+aa__vmem_dealloc(aa_Arena *arena)
+{
+	unsigned char *p = (unsigned char *)arena->blocks + arena->commit_size;
+	struct aa_Block *b = arena->blocks;
+	if (b->end > p) {
+#ifdef MADV_DONTNEED
+		madvise(p, (size_t)(b->end - p), MADV_DONTNEED);
+#else
+		mprotect(p, (size_t)(b->end - p), PROT_NONE);
+		b->end = p;
+#endif
+	}
+}
+
+static void
+aa__vmem_free(aa_Arena *arena)
+{
+	munmap(arena->blocks,
+	       (size_t)(arena->reserve_end - (unsigned char *)arena->blocks));
+}
+#else
+int aa_init_vmem(aa_Arena *a, size_t r, int f) { (void)a,(void)r,(void)f; return 0; }
+static void *aa__vmem_alloc(aa_Arena *a, size_t s, size_t al) { (void)a,(void)s,(void)al; return 0; }
+static void aa__vmem_dealloc(aa_Arena *a) { (void)a; }
+static void aa__vmem_free(aa_Arena *a) { (void)a; }
+#endif
+
+#if defined(MAP_ANONYMOUS) && (defined(__GNUC__) || defined(__clang__))
+int
+aa_concurrent_reserve(aa_ConcurrentArena *shared, size_t reserve,
+                      size_t slab_size, int flags)
+{
+	size_t c = aa_VMEM_COMMIT;
+	shared->size = (reserve + c - 1) & ~(c - 1);
+	shared->slab_size = slab_size ? (slab_size + c - 1) & ~(c - 1) : c;
+	shared->used = 0;
+	shared->base = aa__reserve(shared->size, flags);
+	return shared->base != 0;
+}
+
+void
+aa_concurrent_free(aa_ConcurrentArena *shared)
+{
+	munmap(shared->base, shared->size);
+	shared->base = 0;
+	shared->size = shared->used = 0;
+}
+
+static struct aa_Block *
+aa__concurrent_block(aa_ConcurrentArena *shared, size_t size)
+{
+	size_t c = aa_VMEM_COMMIT, n, off;
+	struct aa_Block *b;
+
+	n = (sizeof *b + size + c - 1) & ~(c - 1);
+	/* the only synchronization point, used may overshoot size, but that
+	 * just means that everyone else will fail as well */
+	off = __atomic_fetch_add(&shared->used, n, __ATOMIC_RELAXED);
+	if (off > shared->size || n > shared->size - off)
+		return 0;
+	b = (struct aa_Block *)(shared->base + off);
+	if (mprotect(b, n, PROT_READ | PROT_WRITE) != 0)
+		return 0;
+	b->end = (unsigned char *)b + n;
+	return b;
+}
+#else
+int aa_concurrent_reserve(aa_ConcurrentArena *s, size_t r, size_t ss, int f) { (void)s,(void)r,(void)ss,(void)f; return 0; }
+void aa_concurrent_free(aa_ConcurrentArena *s) { (void)s; }
+static struct aa_Block *aa__concurrent_block(aa_ConcurrentArena *s, size_t n) { (void)s,(void)n; return 0; }
+#endif
+
+void
+aa_init_concurrent(aa_Arena *arena, aa_ConcurrentArena *shared)
+{
+	arena->blocks = arena->current = arena->large = 0;
+	arena->reserve_end = 0;
+	arena->shared = shared;
+	aa__STATS(memset(&arena->stats, 0, sizeof arena->stats));
+}
+
+static struct aa_Block *
+aa__block_new(aa_Arena *arena, size_t size)
+{
+	struct aa_Block *b;
+	if (arena->shared)
+		b = aa__concurrent_block(arena->shared, size);
+	else if ((b = malloc(sizeof *b + size)))
+		b->end = (unsigned char *)(b + 1) + size;
+	if (b) {
+		b->next = 0;
+		b->first = b->ptr = (unsigned char *)(b + 1);
+		aa__STATS(arena->stats.reserved +=
+		          (size_t)(b->end - (unsigned char *)b));
+	}
+	return b;
+}
+
+static void
+aa__free_blocks(aa_Arena *arena, struct aa_Block *it)
+{
+	struct aa_Block *b;
+	for (b = it; b; b = b->next)
+		aa__STATS(arena->stats.reserved -=
+		          (size_t)(b->end - (unsigned char *)b));
+	/* slabs are owned by the shared arena */
+	if (arena->shared)
+		return;
+	while (it) {
+		b = it;
+		it = it->next;
+		free(b);
+	}
+}
+
+static void *
+aa__alloc_slow(aa_Arena *arena, size_t size, size_t align)
+{
+	struct aa_Block *it = arena->current, *b = it ? it->next : 0;
+	size_t n = aa_BLOCK_SIZE;
+	unsigned char *p;
+
+	if (arena->reserve_end)
+		return aa__vmem_alloc(arena, size, align);
+
+	if (b && size + aa_PAD(b->ptr, align) <= (size_t)(b->end - b->ptr)) {
+		/* reuse a block that was allocated before the last aa_dealloc */
+		aa__STATS(arena->stats.tail_waste += (size_t)(it->end - it->ptr));
+		arena->current = b;
 	} else {
-		/* needs to be allocated */
-		size_t n = sizeof *it + size + aa_BLOCK_SIZE;
-		size_t an = aa_ALIGN_UP(n, aa_MAX_ALIGN);
-		it = malloc(an);
-		if (arena->current)
-			arena->current = prev->next = it;
-		else
-			arena->current = arena->blocks = it;
-		it->next = 0;
-		it->first = (unsigned char *)it + sizeof *it + (an - n);
-		it->ptr = it->first + size;
-		it->end = (unsigned char*)it + an;
+		if (arena->shared) {
+			n = arena->shared->slab_size - sizeof *b;
+		} else if (it) {
+			n = (size_t)(it->end - it->first);
+			n = n < aa_BLOCK_MAX / 2 ? n * 2 : aa_BLOCK_MAX;
+		}
+
+		if (size + align - 1 > n / 4) {
+			/* oversized, doesn't become the current block */
+			if (!(b = aa__block_new(arena, size + align - 1)))
+				return 0;
+			b->next = arena->large;
+			arena->large = b;
+			aa__STATS(++arena->stats.large_blocks);
+		} else {
+			if (!(b = aa__block_new(arena, n)))
+				return 0;
+			aa__STATS(++arena->stats.blocks);
+			if (it) {
+				aa__STATS(arena->stats.tail_waste +=
+				          (size_t)(it->end - it->ptr));
+				b->next = it->next;
+				it->next = b;
+			} else {
+				arena->blocks = b;
+			}
+			arena->current = b;
+		}
 	}
 
-	return it->ptr - old;
+	p = b->ptr + aa_PAD(b->ptr, align);
+	aa__STATS(aa__stats_alloc(arena, size, (size_t)(p - b->ptr)));
+	b->ptr = p + size;
+	return p;
+}
+
+void *
+aa_alloc_aligned(aa_Arena *arena, size_t size, size_t align)
+{
+	struct aa_Block *it = arena->current;
+	unsigned char *p;
+
+	assert(align && !(align & (align - 1)));
+	assert(it ? it->end >= it->ptr : 1);
+
+	/* we only ever try to fit into the current block */
+	if (!it || size + aa_PAD(it->ptr, align) > (size_t)(it->end - it->ptr))
+		return aa__alloc_slow(arena, size, align);
 
-#undef aa_ALIGN_UP
+	p = it->ptr + aa_PAD(it->ptr, align);
+	aa__STATS(aa__stats_alloc(arena, size, (size_t)(p - it->ptr)));
+	it->ptr = p + size;
+	return p;
+}
+
+void *
+aa_alloc(aa_Arena *arena, size_t size)
+{
+	size_t align = size & (0u - size);
+	if (!align || align > aa_MAX_ALIGN)
+		align = aa_MAX_ALIGN;
+	return aa_alloc_aligned(arena, size, align);
+}
+
+void *
+aa_alloc_packed(aa_Arena *arena, size_t size)
+{
+	return aa_alloc_aligned(arena, size, 1);
+}
+
+void *
+aa_realloc(aa_Arena *arena, void *ptr, size_t old, size_t size)
+{
+	struct aa_Block *b = arena->current;
+	unsigned char *p, *q = (unsigned char *)ptr;
+
+	if (q && b && q + old == b->ptr) {
+		/* the last allocation, free it and allocate again, which returns
+		 * the same pointer if it still fits and is aligned */
+		b->ptr = q;
+		aa__STATS(aa__stats_release(arena, old));
+		if (!size)
+			return 0;
+		if (!(p = aa_alloc(arena, size))) {
+			b->ptr = q + old;
+			aa__STATS(aa__stats_alloc(arena, old, 0));
+			return 0;
+		}
+		if (p != q)
+			memmove(p, q, old < size ? old : size);
+		return p;
+	}
+
+	if (!size)
+		return 0;
+	if ((p = aa_alloc(arena, size)) && q)
+		memcpy(p, q, old < size ? old : size);
+	return p;
 }
 
 void
@@ -109,24 +605,198 @@ aa_dealloc(aa_Arena *arena)
 		it = it->next;
 	}
 
+	aa__free_blocks(arena, arena->large);
+	arena->large = 0;
 	arena->current = arena->blocks;
+	if (arena->reserve_end)
+		aa__vmem_dealloc(arena);
+
+	aa__STATS(arena->stats.requested = 0);
+	aa__STATS(arena->stats.padding = 0);
+	aa__STATS(arena->stats.tail_waste = 0);
+	aa__STATS(arena->stats.large_blocks = 0);
+	aa__STATS(++arena->stats.deallocs);
+}
+
+aa_Mark
+aa_mark(aa_Arena *arena)
+{
+	aa_Mark mark;
+	mark.block = arena->current;
+	mark.large = arena->large;
+	mark.ptr = mark.block ? mark.block->ptr : 0;
+	aa__STATS(mark.requested = arena->stats.requested);
+	aa__STATS(mark.padding = arena->stats.padding);
+	aa__STATS(mark.tail_waste = arena->stats.tail_waste);
+	return mark;
 }
 
 void
-aa_free(aa_Arena *arena)
+aa_rewind(aa_Arena *arena, aa_Mark mark)
 {
-	struct aa_Block *it = arena->blocks;
+	struct aa_Block *it = mark.block ? mark.block->next : arena->blocks;
 
-	/* free all blocks */
-	while (it) {
-		struct aa_Block *b = it;
-		it = it->next;
-		free(b);
+	/* the blocks used since the mark directly follow mark.block */
+	if (arena->current != mark.block) {
+		while (it != arena->current) {
+			it->ptr = it->first;
+			it = it->next;
+		}
+		it->ptr = it->first;
 	}
+	if (mark.block)
+		mark.block->ptr = mark.ptr;
+	arena->current = mark.block ? mark.block : arena->blocks;
 
-	arena->current = arena->blocks = 0;
+	/* oversized blocks are pushed to the front of the list */
+	while (arena->large != mark.large) {
+		it = arena->large;
+		arena->large = it->next;
+		it->next = 0;
+		aa__free_blocks(arena, it);
+		aa__STATS(--arena->stats.large_blocks);
+	}
+
+	aa__STATS(arena->stats.requested = mark.requested);
+	aa__STATS(arena->stats.padding = mark.padding);
+	aa__STATS(arena->stats.tail_waste = mark.tail_waste);
+}
+
+void
+aa_pool_init(aa_Pool *pool, aa_Arena *arena, size_t size, size_t align)
+{
+	if (!align) {
+		align = size & (0u - size);
+		if (!align || align > aa_MAX_ALIGN)
+			align = aa_MAX_ALIGN;
+	}
+	assert(!(align & (align - 1)));
+	if (size < sizeof(void *))
+		size = sizeof(void *);
+	pool->size = (size + align - 1) & ~(align - 1);
+	pool->align = align;
+	pool->arena = arena;
+	pool->free = 0;
+	pool->lock = 0;
+}
+
+void *
+aa_pool_alloc(aa_Pool *pool)
+{
+	void *p = pool->free;
+	if (!p)
+		return aa_alloc_aligned(pool->arena, pool->size, pool->align);
+	/* slots might not be sufficiently aligned to store a pointer */
+	memcpy(&pool->free, p, sizeof p);
+	return p;
+}
+
+void
+aa_pool_dealloc(aa_Pool *pool, void *ptr)
+{
+	memcpy(ptr, &pool->free, sizeof ptr);
+	pool->free = ptr;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+static void
+aa__pool_lock(aa_Pool *pool)
+{
+	while (__atomic_exchange_n(&pool->lock, 1, __ATOMIC_ACQUIRE))
+		while (__atomic_load_n(&pool->lock, __ATOMIC_RELAXED))
+			;
+}
+
+static void
+aa__pool_unlock(aa_Pool *pool)
+{
+	__atomic_store_n(&pool->lock, 0, __ATOMIC_RELEASE);
+}
+
+void
+aa_pool_cache_init(aa_PoolCache *cache, aa_Pool *pool)
+{
+	cache->pool = pool;
+	cache->free = 0;
+	cache->count = 0;
+}
+
+void *
+aa_pool_cache_alloc(aa_PoolCache *cache)
+{
+	void *p;
+	if (!cache->free) {
+		/* refill from the pool's free list, or the arena */
+		aa_Pool *pool = cache->pool;
+		aa__pool_lock(pool);
+		while (cache->count < aa_POOL_CACHE) {
+			if (!(p = aa_pool_alloc(pool)))
+				break;
+			memcpy(p, &cache->free, sizeof p);
+			cache->free = p;
+			++cache->count;
+		}
+		aa__pool_unlock(pool);
+		if (!cache->free)
+			return 0;
+	}
+	p = cache->free;
+	memcpy(&cache->free, p, sizeof p);
+	--cache->count;
+	return p;
+}
+
+void
+aa_pool_cache_dealloc(aa_PoolCache *cache, void *ptr)
+{
+	memcpy(ptr, &cache->free, sizeof ptr);
+	cache->free = ptr;
+	if (++cache->count >= 2 * aa_POOL_CACHE) {
+		/* move aa_POOL_CACHE slots back to the pool */
+		void *first = cache->free, *last = first, *next;
+		size_t i;
+		for (i = 1; i < aa_POOL_CACHE; ++i)
+			memcpy(&last, last, sizeof last);
+		memcpy(&next, last, sizeof next);
+		cache->free = next;
+		cache->count -= aa_POOL_CACHE;
+		aa__pool_lock(cache->pool);
+		memcpy(last, &cache->pool->free, sizeof last);
+		cache->pool->free = first;
+		aa__pool_unlock(cache->pool);
+	}
+}
+
+void
+aa_pool_cache_flush(aa_PoolCache *cache)
+{
+	void *p;
+	aa__pool_lock(cache->pool);
+	while ((p = cache->free)) {
+		memcpy(&cache->free, p, sizeof p);
+		aa_pool_dealloc(cache->pool, p);
+	}
+	aa__pool_unlock(cache->pool);
+	cache->count = 0;
+}
+#endif
+
+void
+aa_free(aa_Arena *arena)
+{
+	if (arena->reserve_end)
+		aa__vmem_free(arena);
+	else
+		aa__free_blocks(arena, arena->blocks);
+	aa__free_blocks(arena, arena->large);
+	arena->current = arena->blocks = arena->large = 0;
+	arena->reserve_end = 0;
+	arena->shared = 0;
+	aa__STATS(memset(&arena->stats, 0, sizeof arena->stats));
 }
 
+#undef aa_PAD
+#undef aa__STATS
 #undef ARENA_ALLOCATOR_IMPLEMENT
 #endif
 
@@ -14,15 +14,25 @@
 #include <float.h>
 #include <math.h>
 
+#if defined(__GNUC__) && (defined(__unix__) || defined(__APPLE__))
+# include <pthread.h>
+# include <sched.h>
+# include <unistd.h>
+# define BENCH_HAS_PARALLEL 1
+#endif
+#ifdef __linux__
+# include <errno.h>
+#endif
+
 #if !defined(__pnacl__) && !defined(__EMSCRIPTEN__) && \
     (defined(__clang__) || defined(__GNUC__) || defined(__INTEL_COMPILER))
 
 /* artificial use of all of memory */
-# define BENCH_CLOBBER() asm volatile("":::"memory")
+# define BENCH_CLOBBER() __asm__ __volatile__("":::"memory")
 /* artificial dependency of x on all of memory and all of memory on x */
-# define BENCH_VOLATILE(x) asm volatile("" : "+g"(x) : "g"(x) : "memory")
-# define BENCH_VOLATILE_REG(x) asm volatile("" : "+r"(x) : "r"(x) : "memory")
-# define BENCH_VOLATILE_MEM(x) asm volatile("" : "+m"(x) : "m"(x) : "memory")
+# define BENCH_VOLATILE(x) __asm__ __volatile__("" : "+g"(x) : "g"(x) : "memory")
+# define BENCH_VOLATILE_REG(x) __asm__ __volatile__("" : "+r"(x) : "r"(x) : "memory")
+# define BENCH_VOLATILE_MEM(x) __asm__ __volatile__("" : "+m"(x) : "m"(x) : "memory")
 
 #else
 
@@ -46,33 +56,188 @@ static void bench_use_ptr(char const volatile *x) {}
 #endif
 
 
+/*
+ * Timers:
+ *
+ * BENCH_TIMER selects what is measured, the default is the CPU time of the
+ * process, which includes the time spent in all threads:
+ *
+ *   BENCH_TIMER_CPUTIME:   CLOCK_PROCESS_CPUTIME_ID in seconds
+ *   BENCH_TIMER_MONOTONIC: CLOCK_MONOTONIC_RAW wall time in seconds
+ *   BENCH_TIMER_CYCLES:    rdtsc on x86, with lfence and rdtscp serializing
+ *                          the measured code, or cntvct_el0 on AArch64.
+ *                          Note that these count at a constant reference
+ *                          frequency, which isn't the current core clock.
+ *
+ * Define BENCH_PERF on Linux to additionally count the core cycles,
+ * instructions, cache misses and branch misses of every sample with
+ * perf_event_open(2). If the counters can't be opened, e.g. because of
+ * perf_event_paranoid, a warning is printed and only the timer is used.
+ * This requires _GNU_SOURCE to be defined in strict ISO modes, as syscall(2)
+ * isn't declared otherwise. The counters only cover the calling thread, so
+ * they aren't reported for BENCH_PARALLEL.
+ */
+
+#define BENCH_TIMER_CPUTIME 1
+#define BENCH_TIMER_MONOTONIC 2
+#define BENCH_TIMER_CYCLES 3
+
+#ifndef BENCH_TIMER
+# define BENCH_TIMER BENCH_TIMER_CPUTIME
+#endif
+
+#if BENCH_TIMER == BENCH_TIMER_CYCLES
+# define BENCH_TIMER_UNIT "cycles"
+# if !defined(__GNUC__) || \
+     (!defined(__x86_64__) && !defined(__i386__) && !defined(__aarch64__))
+#  error "BENCH_TIMER_CYCLES isn't supported on this platform"
+# endif
+#else
+# define BENCH_TIMER_UNIT "s"
+#endif
+
+#if defined(BENCH_PERF) && defined(__linux__)
+# include <linux/perf_event.h>
+# include <sys/ioctl.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+# define BENCH_MAX_COUNTERS 4
+#else
+# undef BENCH_PERF
+# define BENCH_MAX_COUNTERS 1
+#endif
+
+typedef struct {
+	double min, mean, M2;
+} BenchStat;
+
+/* robust statistics of the stored samples, see bench_summarize */
+typedef struct {
+	double median, mad, p90, p99, p999;
+	/* bootstrap confidence interval of the median */
+	double ci_lo, ci_hi;
+	/* samples with a modified z-score above 3.5 */
+	size_t outliers;
+} BenchSummary;
+
 typedef struct {
 	size_t count;
 	double min, mean, M2;
 	char const *title;
+	/* number of elements processed per sample, see bench_elements */
+	double elems;
+	/* repetitions per sample chosen by BENCH_AUTO, 0 otherwise */
+	double reps;
+	/* BENCH_PARALLEL: number of threads and the time of each thread */
+	size_t threads;
+	BenchStat thread_time;
+	char *title_buf;
+	/* statistics of the hardware counters, if BENCH_PERF is enabled */
+	BenchStat counters[BENCH_MAX_COUNTERS];
+	/* sample storage, allocated before the timed loop by bench_reserve */
+	double *samples;
+	size_t nsamples, samples_cap;
+	BenchSummary summary;
 } BenchRecord;
 
 typedef struct {
 	size_t count, cap;
 	BenchRecord *records;
+	/* hardware counters, perf_fds[0] is the group leader */
+	int perf_fd, ncounters, perf_fds[BENCH_MAX_COUNTERS];
+	char const *counter_names[BENCH_MAX_COUNTERS];
+	/* environment, see bench_env */
+	int env;
+	char env_desc[256];
+	unsigned char *flush_buf;
+	/* timer overhead, subtracted from BENCH_AUTO samples */
+	double overhead;
+	int has_overhead;
 	/* temporaries */
-	size_t i;
+	size_t i, reps, rep;
+	int calibrating, running;
 	double secs;
+	uint64_t start[BENCH_MAX_COUNTERS];
 } Bench;
 
 static Bench benchInternal;
 
 #define BENCH(title, warmup, samples) \
-	for (bench_append(title), \
+	for (bench_append(title), bench_reserve(samples), \
 	     benchInternal.i = (warmup) + (samples); \
-	     (benchInternal.secs = bench_gettime()), benchInternal.i--; \
-	     benchInternal.i < (samples) ? \
-	     bench_update(bench_gettime()-benchInternal.secs),0 : 0)
+	     bench__sample_start(), benchInternal.i--; \
+	     benchInternal.i < (samples) ? bench__stop(), 0 : 0)
+
+/*
+ * BENCH_AUTO repeats its body, so that every sample runs for about
+ * BENCH_TARGET timer units, and records the statistics per repetition. The
+ * timer overhead is measured once and subtracted from every sample.
+ * With zero samples it only calibrates the number of repetitions, which are
+ * left in benchInternal.reps, and doesn't add a record.
+ * Don't use break in the body: it only ends the current sample early, which is
+ * still recorded as if all repetitions had run.
+ */
+#define BENCH_AUTO(title, samples) \
+	for (bench__auto_begin((title), (samples)); bench__auto_next(); ) \
+		for (benchInternal.rep = benchInternal.reps; \
+		     benchInternal.rep--; )
+
+#ifndef BENCH_TARGET
+# if BENCH_TIMER == BENCH_TIMER_CYCLES
+#  define BENCH_TARGET 2e6
+# else
+#  define BENCH_TARGET 1e-3
+# endif
+#endif
+#define BENCH_MAX_REPS ((size_t)-1 / 16)
+
+#if BENCH_TIMER == BENCH_TIMER_CYCLES
+
+# if defined(__x86_64__) || defined(__i386__)
+/* The lfences keep earlier instructions from executing after the time stamp is
+ * taken, and later ones from executing before it. rdtscp waits for all previous
+ * instructions to complete by itself. */
+static inline double
+bench__cycles_begin(void)
+{
+	uint32_t lo, hi;
+	__asm__ __volatile__("lfence\n\trdtsc\n\tlfence"
+	                 : "=a"(lo), "=d"(hi) :: "memory");
+	return (double)(((uint64_t)hi << 32) | lo);
+}
+
+static inline double
+bench__cycles_end(void)
+{
+	uint32_t lo, hi, aux;
+	__asm__ __volatile__("rdtscp\n\tlfence"
+	                 : "=a"(lo), "=d"(hi), "=c"(aux) :: "memory");
+	return (double)(((uint64_t)hi << 32) | lo);
+}
+# else
+static inline double
+bench__cycles_begin(void)
+{
+	uint64_t t;
+	__asm__ __volatile__("isb\n\tmrs %0, cntvct_el0\n\tisb"
+	                 : "=r"(t) :: "memory");
+	return (double)t;
+}
+#  define bench__cycles_end bench__cycles_begin
+# endif
 
 static inline double
 bench_gettime(void)
 {
-#if defined(CLOCK_PROCESS_CPUTIME_ID)
+	return bench__cycles_begin();
+}
+
+#else
+
+static inline double
+bench_gettime(void)
+{
+#if defined(CLOCK_PROCESS_CPUTIME_ID) && BENCH_TIMER == BENCH_TIMER_CPUTIME
 	struct timespec t;
 	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &t);
 	return t.tv_nsec * 1.0/1000000000 + t.tv_sec;
@@ -85,22 +250,108 @@ bench_gettime(void)
 #endif
 }
 
+#endif
+
+#ifdef BENCH_PERF
+
+static inline int
+bench__perf_open(int group, uint64_t config)
+{
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof attr);
+	attr.size = sizeof attr;
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.config = config;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_GROUP;
+	return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+static inline void
+bench__perf_init(void)
+{
+	static struct { uint64_t config; char const *name; } const events[] = {
+		{ PERF_COUNT_HW_CPU_CYCLES, "cycles" },
+		{ PERF_COUNT_HW_INSTRUCTIONS, "instructions" },
+		{ PERF_COUNT_HW_CACHE_MISSES, "cache-misses" },
+		{ PERF_COUNT_HW_BRANCH_MISSES, "branch-misses" }
+	};
+	Bench *b = &benchInternal;
+	int i, fd;
+	if (b->perf_fd)
+		return;
+	b->perf_fd = -1;
+	for (i = 0; i < BENCH_MAX_COUNTERS; ++i) {
+		fd = bench__perf_open(b->perf_fd, events[i].config);
+		if (fd < 0)
+			continue;
+		if (b->perf_fd < 0)
+			b->perf_fd = fd;
+		b->perf_fds[b->ncounters] = fd;
+		b->counter_names[b->ncounters++] = events[i].name;
+	}
+	if (b->perf_fd < 0) {
+		fprintf(stderr, "bench.h: couldn't open perf counters, "
+		                "check /proc/sys/kernel/perf_event_paranoid\n");
+		b->ncounters = 0;
+	}
+}
+
+static inline void
+bench__perf_read(uint64_t *out)
+{
+	uint64_t buf[BENCH_MAX_COUNTERS + 1];
+	int i;
+	if (benchInternal.ncounters == 0 ||
+	    read(benchInternal.perf_fd, buf, sizeof buf) < (ssize_t)sizeof *buf)
+		return;
+	for (i = 0; i < benchInternal.ncounters; ++i)
+		out[i] = buf[i + 1];
+}
+
+#endif
+
 static inline void
 bench_append(char const *title)
 {
 	Bench *b = &benchInternal;
 	BenchRecord *r;
+#ifdef BENCH_PERF
+	bench__perf_init();
+#endif
 	if (b->count >= b->cap) {
 		b->cap = (b->cap << 1) + 1;
 		b->records = (BenchRecord *)
 		              realloc(b->records, b->cap * sizeof *b->records);
 	}
 	r = &b->records[b->count++];
-	r->mean = r->M2 = r->count = 0;
+	memset(r, 0, sizeof *r);
 	r->min = DBL_MAX;
 	r->title = title;
 }
 
+/* preallocates storage for n samples of the current benchmark, further samples
+ * only update the mean, stddev and min */
+static inline void
+bench_reserve(size_t n)
+{
+	BenchRecord *r = &benchInternal.records[benchInternal.count-1];
+	double *p = (double *)realloc(r->samples, n * sizeof *p);
+	if (p || !n)
+		r->samples = p, r->samples_cap = n;
+}
+
+static inline void
+bench__stat_update(BenchStat *s, size_t count, double x)
+{
+	double const delta = x - s->mean;
+	s->mean += delta / count;
+	s->M2 += delta * (x - s->mean);
+	if (x < s->min || count == 1)
+		s->min = x;
+}
+
 static inline void
 bench_update(double time)
 {
@@ -110,6 +361,577 @@ bench_update(double time)
 	r->M2 += delta * (time - r->mean);
 	if (time < r->min)
 		r->min = time;
+	if (r->nsamples < r->samples_cap)
+		r->samples[r->nsamples++] = time;
+}
+
+/* sets the number of elements, that every sample of the current benchmark
+ * processes, bench_done then additionally reports the mean per element */
+static inline void
+bench_elements(double n)
+{
+	benchInternal.records[benchInternal.count-1].elems = n;
+}
+
+/*
+ * Environment control:
+ *
+ * bench_env(flags, cpu) configures the environment of the following
+ * benchmarks, flags is a combination of:
+ *
+ *   BENCH_ENV_PIN:      pin the calling thread to the given CPU, or to the
+ *                       CPU it's currently running on if cpu is negative
+ *   BENCH_ENV_CHECK:    warn if the frequency governor of the CPU isn't
+ *                       performance, or if turbo boost is enabled
+ *   BENCH_ENV_FLUSH:    evict the caches before every sample by sweeping over
+ *                       a BENCH_FLUSH_SIZE buffer, for cold cache timings
+ *   BENCH_ENV_REALTIME: switch to SCHED_FIFO, if permitted. Note that this can
+ *                       starve the rest of the system while benchmarks spin.
+ *
+ * The resulting configuration is printed by bench_done and included in the
+ * JSON and CSV output. Everything except BENCH_ENV_FLUSH requires Linux, and
+ * pinning additionally requires _GNU_SOURCE for sched_setaffinity.
+ */
+
+#define BENCH_ENV_PIN 1
+#define BENCH_ENV_CHECK 2
+#define BENCH_ENV_FLUSH 4
+#define BENCH_ENV_REALTIME 8
+
+#ifndef BENCH_FLUSH_SIZE
+# define BENCH_FLUSH_SIZE (64*1024*1024)
+#endif
+
+static inline void
+bench_flush_cache(void)
+{
+	unsigned char *p = benchInternal.flush_buf;
+	size_t i;
+	unsigned sum = 0;
+	if (!p)
+		return;
+	for (i = 0; i < BENCH_FLUSH_SIZE; i += 64)
+		sum += p[i]++;
+	BENCH_VOLATILE(sum);
+}
+
+static inline void
+bench__env_append(char const *s)
+{
+	char *d = benchInternal.env_desc;
+	size_t len = strlen(d), n = sizeof benchInternal.env_desc - len - 1;
+	if (len && n > 2)
+		strcat(d, ", "), n -= 2;
+	strncat(d, s, n);
+}
+
+#ifdef __linux__
+/* reads the first line of a sysfs file, returns 0 if it doesn't exist */
+static inline int
+bench__read_line(char const *path, char *buf, int size)
+{
+	FILE *f = fopen(path, "r");
+	int ok;
+	if (!f)
+		return 0;
+	ok = fgets(buf, size, f) != 0;
+	fclose(f);
+	if (ok)
+		buf[strcspn(buf, "\n")] = 0;
+	return ok;
+}
+#endif
+
+static inline void
+bench_env(int flags, int cpu)
+{
+	Bench *b = &benchInternal;
+	char buf[128], path[128];
+
+	b->env = flags;
+	b->env_desc[0] = 0;
+	sprintf(buf, "timer: %s", BENCH_TIMER_UNIT);
+	bench__env_append(buf);
+
+#if defined(__linux__) && defined(CPU_SET)
+	if (cpu < 0)
+		cpu = sched_getcpu();
+	if (flags & BENCH_ENV_PIN) {
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cpu < 0 ? 0 : cpu, &set);
+		if (!sched_setaffinity(0, sizeof set, &set))
+			sprintf(buf, "pinned to cpu %d", cpu);
+		else
+			sprintf(buf, "pinning failed: %s", strerror(errno));
+		bench__env_append(buf);
+	}
+#else
+	if (flags & BENCH_ENV_PIN)
+		bench__env_append("pinning unsupported");
+#endif
+
+#ifdef __linux__
+	if (flags & BENCH_ENV_CHECK) {
+		char val[64];
+		sprintf(path, "/sys/devices/system/cpu/cpu%d/cpufreq/"
+		              "scaling_governor", cpu < 0 ? 0 : cpu);
+		if (bench__read_line(path, val, sizeof val)) {
+			if (strcmp(val, "performance"))
+				fprintf(stderr, "bench.h: the frequency governor "
+				        "is %s instead of performance\n", val);
+			sprintf(buf, "governor: %s", val);
+		} else {
+			sprintf(buf, "governor: unknown");
+		}
+		bench__env_append(buf);
+		if (bench__read_line("/sys/devices/system/cpu/intel_pstate/"
+		                     "no_turbo", val, sizeof val))
+			strcpy(val, strcmp(val, "0") ? "0" : "1");
+		else if (!bench__read_line("/sys/devices/system/cpu/"
+		                           "cpufreq/boost", val, sizeof val))
+			strcpy(val, "?");
+		if (!strcmp(val, "1"))
+			fprintf(stderr, "bench.h: turbo boost is enabled\n");
+		sprintf(buf, "turbo: %s", !strcmp(val, "1") ? "on" :
+		        !strcmp(val, "0") ? "off" : "unknown");
+		bench__env_append(buf);
+	}
+	if (flags & BENCH_ENV_REALTIME) {
+		struct sched_param sp;
+		memset(&sp, 0, sizeof sp);
+		sp.sched_priority = sched_get_priority_min(SCHED_FIFO);
+		if (!sched_setscheduler(0, SCHED_FIFO, &sp))
+			sprintf(buf, "realtime: SCHED_FIFO %d", sp.sched_priority);
+		else
+			sprintf(buf, "realtime: %s", strerror(errno));
+		bench__env_append(buf);
+	}
+#else
+	(void)path;
+	if (flags & (BENCH_ENV_CHECK | BENCH_ENV_REALTIME))
+		bench__env_append("environment checks unsupported");
+#endif
+
+	free(b->flush_buf);
+	b->flush_buf = 0;
+	if (flags & BENCH_ENV_FLUSH) {
+		b->flush_buf = (unsigned char *)calloc(BENCH_FLUSH_SIZE, 1);
+		sprintf(buf, "cache flush: %u KiB",
+		        b->flush_buf ? (unsigned)(BENCH_FLUSH_SIZE / 1024) : 0);
+		bench__env_append(buf);
+	}
+}
+
+static inline void
+bench__start(void)
+{
+#ifdef BENCH_PERF
+	bench__perf_read(benchInternal.start);
+#endif
+#if BENCH_TIMER == BENCH_TIMER_CYCLES
+	benchInternal.secs = bench__cycles_begin();
+#else
+	benchInternal.secs = bench_gettime();
+#endif
+}
+
+static inline void
+bench__sample_start(void)
+{
+	if (benchInternal.flush_buf)
+		bench_flush_cache();
+	bench__start();
+}
+
+/* time and counter deltas since bench__start */
+static inline double
+bench__elapsed(uint64_t *ctr)
+{
+#if BENCH_TIMER == BENCH_TIMER_CYCLES
+	double t = bench__cycles_end() - benchInternal.secs;
+#else
+	double t = bench_gettime() - benchInternal.secs;
+#endif
+#ifdef BENCH_PERF
+	int i;
+	bench__perf_read(ctr);
+	for (i = 0; i < benchInternal.ncounters; ++i)
+		ctr[i] -= benchInternal.start[i];
+#else
+	(void)ctr;
+#endif
+	return t;
+}
+
+/* adds a sample of reps operations, the statistics are per operation */
+static inline void
+bench__record(double t, uint64_t const *ctr, double reps)
+{
+#ifdef BENCH_PERF
+	Bench *b = &benchInternal;
+	BenchRecord *r = &b->records[b->count-1];
+	int i;
+	for (i = 0; i < b->ncounters; ++i)
+		bench__stat_update(&r->counters[i], r->count + 1,
+		                   (double)ctr[i] / reps);
+#else
+	(void)ctr;
+#endif
+	bench_update(t / reps);
+}
+
+static inline void
+bench__stop(void)
+{
+	uint64_t ctr[BENCH_MAX_COUNTERS];
+	double t = bench__elapsed(ctr);
+	bench__record(t, ctr, 1);
+}
+
+/* minimum time between bench__start and bench__elapsed */
+static inline double
+bench__overhead(void)
+{
+	uint64_t ctr[BENCH_MAX_COUNTERS];
+	double t, min = DBL_MAX;
+	int i;
+	for (i = 0; i < 1024; ++i) {
+		bench__start();
+		if ((t = bench__elapsed(ctr)) < min)
+			min = t;
+	}
+	return min;
+}
+
+static inline void
+bench__auto_begin(char const *title, size_t samples)
+{
+	Bench *b = &benchInternal;
+#ifdef BENCH_PERF
+	/* the overhead includes reading the counters */
+	bench__perf_init();
+#endif
+	if (!b->has_overhead)
+		b->overhead = bench__overhead(), b->has_overhead = 1;
+	bench_append(title);
+	bench_reserve(samples);
+	b->i = samples;
+	b->reps = 1;
+	b->calibrating = 1;
+	b->running = 0;
+}
+
+/* stops the previous sample, if any, and starts the next one */
+static inline int
+bench__auto_next(void)
+{
+	Bench *b = &benchInternal;
+	uint64_t ctr[BENCH_MAX_COUNTERS];
+	if (b->running) {
+		double t = bench__elapsed(ctr) - b->overhead;
+		if (t < 0)
+			t = 0;
+		if (!b->calibrating) {
+			bench__record(t, ctr, (double)b->reps);
+			if (--b->i == 0) {
+				b->records[b->count-1].reps = (double)b->reps;
+				return b->running = 0;
+			}
+		} else if (t < BENCH_TARGET / 10 && b->reps < BENCH_MAX_REPS) {
+			b->reps *= 10;
+		} else {
+			/* scale to the target, the calibration runs were the
+			 * warmup */
+			if (t > 0)
+				b->reps = (size_t)(b->reps * (BENCH_TARGET / t)) + 1;
+			b->calibrating = 0;
+			if (b->i == 0) {
+				/* calibration only, there are no samples to
+				 * report, the result is left in b->reps */
+				free(b->records[b->count-1].samples);
+				--b->count;
+				return b->running = 0;
+			}
+		}
+	}
+	b->running = 1;
+	bench__sample_start();
+	return 1;
+}
+
+#ifdef BENCH_HAS_PARALLEL
+
+/*
+ * BENCH_PARALLEL(title, threads, warmup, samples, fn, arg) calls
+ * fn(arg, thread) on the given number of threads, which are pinned to
+ * separate CPUs if possible and start every sample together. A sample is the
+ * wall time from the first thread starting until the last thread finished, as
+ * measured by the threads themselves, and the time of every individual thread
+ * is recorded in thread_time. bench_done
+ * additionally prints the aggregate throughput in calls, or elements if
+ * bench_elements is used afterwards, per timer unit.
+ *
+ * bench_parallel_sweep runs the benchmark for 1, 2, 4, ... and max threads.
+ *
+ * The samples are booked to the record bench_parallel appended, so fn must not
+ * use any other part of bench.h.
+ */
+
+#define BENCH_PARALLEL(title, threads, warmup, samples, fn, arg) \
+	bench_parallel((title), (threads), (warmup), (samples), (fn), (arg))
+
+typedef struct {
+	void (*fn)(void *arg, size_t thread);
+	void *arg;
+	size_t threads, samples, gen, ready, done;
+} BenchParallel;
+
+typedef struct {
+	BenchParallel *p;
+	pthread_t handle;
+	size_t id;
+	double begin, end;
+} BenchThread;
+
+static inline double
+bench__walltime(void)
+{
+#if BENCH_TIMER == BENCH_TIMER_CYCLES
+	return bench__cycles_begin();
+#elif defined(CLOCK_MONOTONIC_RAW)
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC_RAW, &t);
+	return t.tv_nsec * 1.0/1000000000 + t.tv_sec;
+#else
+	return bench_gettime();
+#endif
+}
+
+/* spin while *p != v, but give up the time slice if it takes longer */
+static inline void
+bench__wait(size_t *p, size_t v)
+{
+	unsigned spin = 0;
+	while (__atomic_load_n(p, __ATOMIC_ACQUIRE) != v)
+		if (++spin > 64)
+			sched_yield(), spin = 0;
+}
+
+static inline void *
+bench__worker(void *arg)
+{
+	BenchThread *t = (BenchThread *)arg;
+	BenchParallel *p = t->p;
+	size_t s;
+#if defined(__linux__) && defined(CPU_SET)
+	cpu_set_t set;
+	long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+	CPU_ZERO(&set);
+	CPU_SET(ncpu > 0 ? t->id % (size_t)ncpu : 0, &set);
+	pthread_setaffinity_np(pthread_self(), sizeof set, &set);
+#endif
+	for (s = 1; s <= p->samples; ++s) {
+		__atomic_fetch_add(&p->ready, 1, __ATOMIC_ACQ_REL);
+		bench__wait(&p->gen, s);
+		t->begin = bench__walltime();
+		p->fn(p->arg, t->id);
+		t->end = bench__walltime();
+		__atomic_fetch_add(&p->done, 1, __ATOMIC_ACQ_REL);
+	}
+	return 0;
+}
+
+/* returns 0 if the threads couldn't be created */
+static inline int
+bench_parallel(char const *title, size_t threads, size_t warmup,
+               size_t samples, void (*fn)(void *arg, size_t thread),
+               void *arg)
+{
+	BenchParallel p;
+	BenchThread *t;
+	BenchRecord *r;
+	size_t i, s, n;
+
+	if (!(t = (BenchThread *)malloc(threads * sizeof *t)))
+		return 0;
+	bench_append(title);
+	bench_reserve(samples);
+	r = &benchInternal.records[benchInternal.count-1];
+	r->threads = threads;
+
+	memset(&p, 0, sizeof p);
+	p.fn = fn;
+	p.arg = arg;
+	p.threads = threads;
+	p.samples = warmup + samples;
+	for (n = 0; n < threads; ++n) {
+		t[n].p = &p;
+		t[n].id = n;
+		if (pthread_create(&t[n].handle, 0, bench__worker, t + n))
+			break;
+	}
+
+	/* If not all threads could be created, the created ones still need
+	 * to run through all samples, but nothing is recorded. */
+	for (s = 1; s <= warmup + samples; ++s) {
+		double begin, end;
+		bench__wait(&p.ready, n * s);
+		if (benchInternal.flush_buf)
+			bench_flush_cache();
+		__atomic_store_n(&p.gen, s, __ATOMIC_RELEASE);
+		bench__wait(&p.done, n * s);
+		if (s <= warmup || n < threads)
+			continue;
+		begin = t[0].begin, end = t[0].end;
+		for (i = 0; i < threads; ++i) {
+			bench__stat_update(&r->thread_time,
+			                   (r->count * threads) + i + 1,
+			                   t[i].end - t[i].begin);
+			if (t[i].begin < begin)
+				begin = t[i].begin;
+			if (t[i].end > end)
+				end = t[i].end;
+		}
+		bench_update(end - begin);
+	}
+
+	for (i = 0; i < n; ++i)
+		pthread_join(t[i].handle, 0);
+	free(t);
+	if (n < threads) {
+		free(r->samples);
+		--benchInternal.count;
+		return 0;
+	}
+	return 1;
+}
+
+static inline int
+bench_parallel_sweep(char const *title, size_t max, size_t warmup,
+                     size_t samples, void (*fn)(void *arg, size_t thread),
+                     void *arg)
+{
+	size_t n, len = strlen(title) + 32;
+	for (n = 1; n <= max; n = n * 2 > max && n < max ? max : n * 2) {
+		char *buf = (char *)malloc(len);
+		if (!buf)
+			return 0;
+		sprintf(buf, "%s (%u threads)", title, (unsigned)n);
+		if (!bench_parallel(buf, n, warmup, samples, fn, arg)) {
+			free(buf);
+			return 0;
+		}
+		benchInternal.records[benchInternal.count-1].title_buf = buf;
+	}
+	return 1;
+}
+
+#endif
+
+static inline uint64_t
+bench_hash64(uint64_t x)
+{
+	x ^= x >> 30;
+	x *= 0xBF58476D1CE4E5B9u;
+	x ^= x >> 27;
+	x *= 0x94D049BB133111EBu;
+	x ^= x >> 31;
+	return x;
+}
+
+static inline int
+bench__double_cmp(void const *lhs, void const *rhs)
+{
+	double l = *(double const *)lhs, r = *(double const *)rhs;
+	return l < r ? -1 : l > r;
+}
+
+/* linear interpolation between the closest ranks of sorted samples */
+static inline double
+bench__quantile(double const *sorted, size_t n, double p)
+{
+	double pos = p * (double)(n - 1);
+	size_t i = (size_t)pos;
+	if (i + 1 >= n)
+		return sorted[n - 1];
+	return sorted[i] + (pos - (double)i) * (sorted[i + 1] - sorted[i]);
+}
+
+#ifndef BENCH_BOOTSTRAP
+# define BENCH_BOOTSTRAP 1000
+#endif
+
+/* sorts the samples of r and computes r->summary */
+static inline void
+bench_summarize(BenchRecord *r)
+{
+	BenchSummary *s = &r->summary;
+	size_t n = r->nsamples, i, j;
+	double *tmp, *medians;
+	uint64_t seed = 0;
+
+	memset(s, 0, sizeof *s);
+	if (n == 0)
+		return;
+	qsort(r->samples, n, sizeof *r->samples, bench__double_cmp);
+	s->median = bench__quantile(r->samples, n, 0.5);
+	s->p90 = bench__quantile(r->samples, n, 0.9);
+	s->p99 = bench__quantile(r->samples, n, 0.99);
+	s->p999 = bench__quantile(r->samples, n, 0.999);
+	s->ci_lo = s->ci_hi = s->median;
+
+	if (!(tmp = (double *)malloc(n * sizeof *tmp)))
+		return;
+	for (i = 0; i < n; ++i)
+		tmp[i] = fabs(r->samples[i] - s->median);
+	qsort(tmp, n, sizeof *tmp, bench__double_cmp);
+	s->mad = bench__quantile(tmp, n, 0.5);
+	for (i = 0; i < n; ++i)
+		if (0.6745 * fabs(r->samples[i] - s->median) > 3.5 * s->mad)
+			++s->outliers;
+
+	/* percentile bootstrap of the median */
+	medians = (double *)malloc(BENCH_BOOTSTRAP * sizeof *medians);
+	if (medians && n > 1) {
+		for (j = 0; j < BENCH_BOOTSTRAP; ++j) {
+			for (i = 0; i < n; ++i)
+				tmp[i] = r->samples[bench_hash64(seed++) % n];
+			qsort(tmp, n, sizeof *tmp, bench__double_cmp);
+			medians[j] = bench__quantile(tmp, n, 0.5);
+		}
+		qsort(medians, BENCH_BOOTSTRAP, sizeof *medians,
+		      bench__double_cmp);
+		s->ci_lo = bench__quantile(medians, BENCH_BOOTSTRAP, 0.025);
+		s->ci_hi = bench__quantile(medians, BENCH_BOOTSTRAP, 0.975);
+	}
+	free(medians);
+	free(tmp);
+}
+
+/* prints a histogram of the samples of r with logarithmic buckets, four per
+ * power of two, r must have been summarized */
+static inline void
+bench_histogram(FILE *f, BenchRecord const *r)
+{
+	size_t cnt[256] = { 0 }, i, j, max = 0, nb = 0;
+	double const lo = r->nsamples ? r->samples[0] : 0;
+	if (!r->nsamples || lo <= 0)
+		return;
+	for (i = 0; i < r->nsamples; ++i) {
+		size_t k = (size_t)(log(r->samples[i] / lo) / log(2) * 4);
+		k = k < 255 ? k : 255;
+		if (++cnt[k] > max)
+			max = cnt[k];
+		if (k + 1 > nb)
+			nb = k + 1;
+	}
+	for (i = 0; i < nb; ++i) {
+		fprintf(f, "  %.3e %6u ", lo * pow(2, i / 4.0), (unsigned)cnt[i]);
+		for (j = 0; j < (cnt[i] * 40 + max - 1) / max; ++j)
+			fputc('#', f);
+		fputc('\n', f);
+	}
 }
 
 static inline int
@@ -117,62 +939,353 @@ bench_record_cmp(void const *lhs, void const *rhs)
 {
 	BenchRecord const *l = (BenchRecord const *)lhs;
 	BenchRecord const *r = (BenchRecord const *)rhs;
+#ifdef BENCH_ROBUST
+	return l->summary.median > r->summary.median ? 1 : -1;
+#else
 	return l->mean > r->mean ? 1 : -1;
+#endif
 }
 
+/*
+ * bench_done prints the mean, stddev and min of every benchmark, relative to
+ * the fastest one, unless BENCH_DONT_NORMALIZE is defined. Define BENCH_ROBUST
+ * to print the median, median absolute deviation, p99, p99.9, the 95%
+ * bootstrap confidence interval of the median and the number of outliers
+ * instead, and BENCH_HISTOGRAM to also print a histogram of every benchmark.
+ */
 static inline void
 bench_done(void)
 {
 	size_t i, j, maxlen;
-	double minmean = DBL_MAX;
+	int k;
+	double norm = DBL_MAX;
 	Bench *b = &benchInternal;
+
+	for (i = 0; i < b->count; ++i)
+		bench_summarize(&b->records[i]);
 	qsort(b->records, b->count, sizeof *b->records, bench_record_cmp);
 
 	for (maxlen = i = 0; i < b->count; ++i) {
-		size_t l = strlen(b->records[i].title);
+		BenchRecord const *r = &b->records[i];
+		size_t l = strlen(r->title);
 		if (l > maxlen)
 			maxlen = l;
-		if (b->records[i].mean < minmean)
-			minmean = b->records[i].mean;
+#ifdef BENCH_ROBUST
+		if (r->summary.median < norm)
+			norm = r->summary.median;
+#else
+		if (r->mean < norm)
+			norm = r->mean;
+#endif
 	}
+#ifdef BENCH_DONT_NORMALIZE
+	norm = 1;
+#endif
+
+	if (b->env_desc[0] && b->count)
+		printf("environment: %s\n", b->env_desc);
 
 	for (i = 0; i < b->count; ++i) {
-		int l = printf("%s:", b->records[i].title) - 4;
+		BenchRecord const *r = &b->records[i];
+		BenchSummary const *s = &r->summary;
+		double const per = r->elems > 0 ? r->elems : 1;
+		int l = printf("%s:", r->title) - 4;
 
 		for (j = 0; j < maxlen-l; ++j)
 			putchar(' ');
 
-		printf("mean: %.9e,   stddev: %.2e,   min: %.9e \n",
-#ifdef BENCH_DONT_NORMALIZE
-		       b->records[i].mean,
-		       sqrt(b->records[i].M2 / b->records[i].count),
+#ifdef BENCH_ROBUST
+		printf("median: %.9e,   MAD: %.2e,   p99: %.3e,   p99.9: %.3e,"
+		       "   95%% CI: [%.3e, %.3e] ",
+		       s->median / norm, s->mad / norm, s->p99 / norm,
+		       s->p999 / norm, s->ci_lo / norm, s->ci_hi / norm);
+		if (s->outliers)
+			printf("  outliers: %u ", (unsigned)s->outliers);
+		if (r->elems > 0 && !r->threads)
+			printf("  %s/elem: %.3e ", BENCH_TIMER_UNIT,
+			       s->median / per);
 #else
-		       b->records[i].mean / minmean,
-		       sqrt(b->records[i].M2 / b->records[i].count) / minmean,
+		printf("mean: %.9e,   stddev: %.2e,   min: %.9e ",
+		       r->mean / norm, sqrt(r->M2 / r->count) / norm, r->min);
+		if (r->elems > 0 && !r->threads)
+			printf("  %s/elem: %.3e ", BENCH_TIMER_UNIT, r->mean / per);
+#endif
+		if (r->threads) {
+			double const th = r->thread_time.mean;
+			printf("  threads: %u,   %s/%s: %.3e,   thread mean: %.3e,"
+			       "   thread stddev: %.2e ", (unsigned)r->threads,
+			       r->elems > 0 ? "elems" : "calls", BENCH_TIMER_UNIT,
+			       (double)r->threads * per / r->mean, th,
+			       sqrt(r->thread_time.M2 /
+			            (double)(r->count * r->threads)));
+		}
+		for (k = 0; k < (r->threads ? 0 : b->ncounters); ++k)
+			printf("  %s%s: %.3f ", b->counter_names[k],
+			       r->elems > 0 ? "/elem" : "",
+			       r->counters[k].mean / per);
+		putchar('\n');
+#ifdef BENCH_HISTOGRAM
+		bench_histogram(stdout, r);
 #endif
-		       b->records[i].min);
+		(void)s;
+	}
+
+	for (i = 0; i < b->count; ++i) {
+		free(b->records[i].samples);
+		free(b->records[i].title_buf);
 	}
 	b->count = 0;
 }
 
+/*
+ * Machine readable output and regression checks:
+ *
+ * bench_write_csv and bench_write_json write the statistics and samples of
+ * the current benchmarks, so they must be called before bench_done.
+ *
+ * bench_compare reads the CSV of a previous run and compares the median of
+ * every benchmark with the same title. A benchmark regressed, if its median
+ * is more than threshold (e.g. 0.05 for 5%) slower and a two-sided
+ * Mann-Whitney U test on the samples rejects equality at BENCH_ALPHA. The
+ * comparison is printed to out, and the number of regressions is returned.
+ */
+
+#ifndef BENCH_ALPHA
+# define BENCH_ALPHA 0.01
+#endif
+
 static inline void
-bench_free(void)
+bench__write_str(FILE *f, char const *s, char quote, char esc)
 {
-	free(benchInternal.records);
+	fputc(quote, f);
+	for (; *s; ++s) {
+		if (*s == quote || *s == esc)
+			fputc(esc, f);
+		fputc(*s, f);
+	}
+	fputc(quote, f);
 }
 
+static inline void
+bench_write_csv(FILE *f)
+{
+	Bench *b = &benchInternal;
+	size_t i, j;
+	if (b->env_desc[0])
+		fprintf(f, "# %s\n", b->env_desc);
+	fprintf(f, "title,count,mean,stddev,min,median,mad,p99,p999,"
+	           "elems,samples\n");
+	for (i = 0; i < b->count; ++i) {
+		BenchRecord *r = &b->records[i];
+		bench_summarize(r);
+		bench__write_str(f, r->title, '"', '"');
+		fprintf(f, ",%u,%.9e,%.9e,%.9e,%.9e,%.9e,%.9e,%.9e,%.9e,",
+		        (unsigned)r->count, r->mean, sqrt(r->M2 / r->count),
+		        r->min, r->summary.median, r->summary.mad,
+		        r->summary.p99, r->summary.p999, r->elems);
+		for (j = 0; j < r->nsamples; ++j)
+			fprintf(f, j ? " %.9e" : "%.9e", r->samples[j]);
+		fputc('\n', f);
+	}
+}
 
-static inline uint64_t
-bench_hash64(uint64_t x)
+static inline void
+bench_write_json(FILE *f)
 {
-	x ^= x >> 30;
-	x *= 0xBF58476D1CE4E5B9u;
-	x ^= x >> 27;
-	x *= 0x94D049BB133111EBu;
-	x ^= x >> 31;
-	return x;
+	Bench *b = &benchInternal;
+	size_t i, j;
+	int k;
+	fprintf(f, "{\n  \"timer_unit\": \"%s\",\n  \"env\": ",
+	        BENCH_TIMER_UNIT);
+	bench__write_str(f, b->env_desc, '"', '\\');
+	fprintf(f, ",\n  \"benchmarks\": [");
+	for (i = 0; i < b->count; ++i) {
+		BenchRecord *r = &b->records[i];
+		BenchSummary const *s = &r->summary;
+		bench_summarize(r);
+		fprintf(f, "%s\n    {\n      \"title\": ", i ? "," : "");
+		bench__write_str(f, r->title, '"', '\\');
+		fprintf(f, ",\n      \"count\": %u, \"mean\": %.9e, "
+		           "\"stddev\": %.9e, \"min\": %.9e,\n",
+		        (unsigned)r->count, r->mean, sqrt(r->M2 / r->count),
+		        r->min);
+		fprintf(f, "      \"median\": %.9e, \"mad\": %.9e, "
+		           "\"p90\": %.9e, \"p99\": %.9e, \"p999\": %.9e,\n",
+		        s->median, s->mad, s->p90, s->p99, s->p999);
+		fprintf(f, "      \"ci\": [%.9e, %.9e], \"outliers\": %u, "
+		           "\"elems\": %.9e, \"reps\": %.9e,\n",
+		        s->ci_lo, s->ci_hi, (unsigned)s->outliers,
+		        r->elems, r->reps);
+		if (r->threads)
+			fprintf(f, "      \"threads\": %u, \"thread_mean\": %.9e, "
+			           "\"thread_stddev\": %.9e,\n",
+			        (unsigned)r->threads, r->thread_time.mean,
+			        sqrt(r->thread_time.M2 /
+			             (double)(r->count * r->threads)));
+		fprintf(f, "      \"counters\": {");
+		for (k = 0; k < (r->threads ? 0 : b->ncounters); ++k)
+			fprintf(f, "%s\"%s\": %.9e", k ? ", " : "",
+			        b->counter_names[k], r->counters[k].mean);
+		fprintf(f, "},\n      \"samples\": [");
+		for (j = 0; j < r->nsamples; ++j)
+			fprintf(f, j ? ", %.9e" : "%.9e", r->samples[j]);
+		fprintf(f, "]\n    }");
+	}
+	fprintf(f, "\n  ]\n}\n");
+}
+
+/* two-sided p-value of the Mann-Whitney U test, using the normal
+ * approximation with tie correction, a and b must be sorted */
+static inline double
+bench_mann_whitney(double const *a, size_t na, double const *b, size_t nb)
+{
+	size_t i = 0, j = 0, n = na + nb;
+	double ra = 0, ties = 0, u, mu, sigma, z;
+	if (na == 0 || nb == 0)
+		return 1;
+	while (i < na || j < nb) {
+		/* the next group of equal values gets the average rank */
+		double v = j >= nb || (i < na && a[i] <= b[j]) ? a[i] : b[j];
+		size_t ca = 0, cb = 0;
+		double rank, t;
+		while (i < na && a[i] == v)
+			++i, ++ca;
+		while (j < nb && b[j] == v)
+			++j, ++cb;
+		t = (double)(ca + cb);
+		rank = (double)(i + j) - (t - 1) / 2;
+		ra += rank * (double)ca;
+		ties += t * t * t - t;
+	}
+	u = ra - (double)na * ((double)na + 1) / 2;
+	mu = (double)na * (double)nb / 2;
+	sigma = sqrt((double)na * (double)nb / 12 *
+	             (((double)n + 1) - ties / ((double)n * ((double)n - 1))));
+	if (sigma == 0)
+		return 1;
+	z = (fabs(u - mu) - 0.5) / sigma;
+	return z < 0 ? 1 : erfc(z / sqrt(2));
 }
 
+/* reads the next field of a CSV line into *buf, returns the delimiter */
+static inline int
+bench__read_field(FILE *f, char **buf, size_t *cap)
+{
+	size_t len = 0;
+	int c, quoted = 0;
+	for (;;) {
+		c = fgetc(f);
+		if (c == '"') {
+			if (quoted && (c = fgetc(f)) != '"') {
+				quoted = 0;
+				ungetc(c, f);
+				continue;
+			} else if (!quoted && len == 0) {
+				quoted = 1;
+				continue;
+			}
+		}
+		if (c == EOF || (!quoted && (c == ',' || c == '\n')))
+			break;
+		if (len + 2 > *cap) {
+			char *p = (char *)realloc(*buf, *cap * 2 + 64);
+			if (!p)
+				break;
+			*buf = p, *cap = *cap * 2 + 64;
+		}
+		(*buf)[len++] = (char)c;
+	}
+	if (*buf)
+		(*buf)[len] = 0;
+	return c;
+}
+
+static inline int
+bench_compare(FILE *baseline, double threshold, FILE *out)
+{
+	Bench *b = &benchInternal;
+	char *title = 0, *field = 0;
+	size_t tcap = 0, fcap = 0, i, n, cap = 0;
+	double *samples = 0, x;
+	int c, regressions = 0;
+
+	/* skip the environment comment and the header */
+	do {
+		c = fgetc(baseline);
+		while (c != EOF && c != '\n')
+			c = fgetc(baseline);
+	} while (c != EOF && (c = fgetc(baseline)) == '#');
+	if (c != EOF)
+		ungetc(c, baseline);
+
+	while (bench__read_field(baseline, &title, &tcap) == ',') {
+		BenchRecord *r = 0;
+		double base, delta, p;
+		char *s, *end;
+		/* skip to the samples field */
+		for (i = 0; i < 9; ++i)
+			c = bench__read_field(baseline, &field, &fcap);
+		c = bench__read_field(baseline, &field, &fcap);
+		for (n = 0, s = field; s && (x = strtod(s, &end), end != s);
+		     s = end) {
+			if (n >= cap) {
+				double *p2 = (double *)
+				      realloc(samples, (cap * 2 + 64) * sizeof *p2);
+				if (!p2)
+					break;
+				samples = p2, cap = cap * 2 + 64;
+			}
+			samples[n++] = x;
+		}
+
+		for (i = 0; i < b->count; ++i)
+			if (!strcmp(b->records[i].title, title))
+				r = &b->records[i];
+		if (!r || n == 0 || r->nsamples == 0)
+			continue;
+		bench_summarize(r);
+		qsort(samples, n, sizeof *samples, bench__double_cmp);
+		base = bench__quantile(samples, n, 0.5);
+		delta = base > 0 ? r->summary.median / base - 1 : 0;
+		p = bench_mann_whitney(r->samples, r->nsamples, samples, n);
+		fprintf(out, "%s: %+.2f%% (p=%.3g)", title, delta * 100, p);
+		if (p < BENCH_ALPHA && delta > threshold) {
+			fprintf(out, " REGRESSION");
+			++regressions;
+		} else if (p < BENCH_ALPHA && delta < -threshold) {
+			fprintf(out, " improvement");
+		}
+		fputc('\n', out);
+		if (c == EOF)
+			break;
+	}
+	free(title);
+	free(field);
+	free(samples);
+	return regressions;
+}
+
+static inline void
+bench_free(void)
+{
+	size_t i;
+#ifdef BENCH_PERF
+	for (i = 0; i < (size_t)benchInternal.ncounters; ++i)
+		close(benchInternal.perf_fds[i]);
+	benchInternal.ncounters = benchInternal.perf_fd = 0;
+#endif
+	for (i = 0; i < benchInternal.count; ++i) {
+		free(benchInternal.records[i].samples);
+		free(benchInternal.records[i].title_buf);
+	}
+	free(benchInternal.records);
+	benchInternal.records = 0;
+	benchInternal.count = benchInternal.cap = 0;
+	free(benchInternal.flush_buf);
+	benchInternal.flush_buf = 0;
+}
+
+
 #define BENCH_H_INCLUDED
 #endif
 
@@ -189,8 +1302,10 @@ int
 main(void)
 {
 	size_t i;
+	bench_env(BENCH_ENV_PIN | BENCH_ENV_CHECK, -1);
 	BENCH("sum", 8, 64) {
 		unsigned int sum = 0;
+		bench_elements(1024*16);
 		for (i = 0; i < 1024*16u; ++i) {
 			sum += i;
 			BENCH_VOLATILE_REG(sum);
@@ -203,6 +1318,12 @@ main(void)
 			BENCH_VOLATILE_REG(sum);
 		}
 	}
+	BENCH_AUTO("single add", 64) {
+		unsigned int sum = 0;
+		BENCH_VOLATILE_REG(sum);
+		sum += 1;
+		BENCH_VOLATILE_REG(sum);
+	}
 	bench_done();
 	return 0;
 }
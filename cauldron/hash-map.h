@@ -0,0 +1,404 @@
+/* hash-map.h -- generic open addressing hash map
+ * Olaf Bernstein <camel-cdr@protonmail.com>
+ * Distributed under the MIT license, see license at the end of the file.
+ * New versions available at https://github.com/camel-cdr/cauldron
+ *
+ * A Swiss table in the style of stretchy-buffer.h: Every slot has a control
+ * byte, that is either empty, deleted or holds the lower 7 bits of the hash of
+ * the key stored in the slot. Lookups compare the control bytes of a group of
+ * 16 slots at once, using SSE2 if available, and only compare the keys of
+ * matching slots. Keys and values are stored in separate arrays.
+ *
+ * Keys are hashed and compared bytewise, so they mustn't contain padding or
+ * pointers to the actual data, like strings. hm_hash(ptr,size) can be
+ * redefined to use a different hash function.
+ *
+ * Note that any arguments passed to a hm_* function macros is potentially
+ * evaluated multiple times except for arguments that have the name k or v in
+ * the code bellow. The maps passed to hm_* mustn't be used in k or v.
+ */
+
+#ifndef HASH_MAP_H_INCLUDED
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define hm__SSE2 1
+#endif
+
+
+/* by default: exit on allocation failure, like stretchy-buffer.h */
+
+#ifndef hm_malloc
+static inline void *
+hm__malloc(size_t num_bytes)
+{
+	void *ptr;
+	if (!(ptr = malloc(num_bytes)))
+		perror("malloc failed"), exit(EXIT_FAILURE);
+	return ptr;
+}
+#define hm_malloc(s) hm__malloc(s)
+#endif
+#ifndef hm_dealloc
+#define hm_dealloc(p) free(p)
+#endif
+
+
+#ifndef hm_hash
+#define hm_hash(p,s) hm__hash(p, s)
+#endif
+
+/* mixing function from bench_hash64 and splitmix64 */
+static inline uint64_t
+hm__mix(uint64_t x)
+{
+	x ^= x >> 30;
+	x *= UINT64_C(0xBF58476D1CE4E5B9);
+	x ^= x >> 27;
+	x *= UINT64_C(0x94D049BB133111EB);
+	x ^= x >> 31;
+	return x;
+}
+
+static inline uint64_t
+hm__hash(void const *ptr, size_t size)
+{
+	unsigned char const *p = (unsigned char const *)ptr;
+	uint64_t h = size * UINT64_C(0x9E3779B97F4A7C15), x;
+	for (; size >= 8; size -= 8, p += 8) {
+		memcpy(&x, p, 8);
+		h = hm__mix(h ^ x);
+	}
+	if (size) {
+		x = 0;
+		memcpy(&x, p, size);
+		h = hm__mix(h ^ x);
+	}
+	return h;
+}
+
+
+#define HM_GROUP 16
+#define HM_EMPTY 0x80
+#define HM_DELETED 0xFE
+#define HM_NONE ((size_t)-1)
+
+typedef struct {
+	/* cap + HM_GROUP control bytes, the last group mirrors the first one,
+	 * so a group can be loaded starting at any slot */
+	unsigned char *ctrl;
+	void *keys, *vals;
+	/* left: insertions into empty slots until a rehash is needed */
+	size_t len, cap, left;
+} HmCore;
+
+static inline unsigned
+hm__ctz(unsigned x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return (unsigned)__builtin_ctz(x);
+#else
+	unsigned n = 0;
+	for (; !(x & 1); x >>= 1)
+		++n;
+	return n;
+#endif
+}
+
+/* bitmask of the slots in the group with the control byte b */
+static inline unsigned
+hm__match(unsigned char const *g, unsigned char b)
+{
+#ifdef hm__SSE2
+	__m128i v = _mm_loadu_si128((__m128i const *)g);
+	return (unsigned)_mm_movemask_epi8(
+			_mm_cmpeq_epi8(v, _mm_set1_epi8((char)b)));
+#else
+	unsigned m = 0, i;
+	for (i = 0; i < HM_GROUP; ++i)
+		m |= (unsigned)(g[i] == b) << i;
+	return m;
+#endif
+}
+
+/* bitmask of the empty or deleted slots in the group */
+static inline unsigned
+hm__match_free(unsigned char const *g)
+{
+#ifdef hm__SSE2
+	return (unsigned)_mm_movemask_epi8(
+			_mm_loadu_si128((__m128i const *)g));
+#else
+	unsigned m = 0, i;
+	for (i = 0; i < HM_GROUP; ++i)
+		m |= (unsigned)(g[i] >> 7) << i;
+	return m;
+#endif
+}
+
+static inline void
+hm__setctrl(HmCore *c, size_t i, unsigned char b)
+{
+	c->ctrl[i] = b;
+	c->ctrl[((i - HM_GROUP) & (c->cap - 1)) + HM_GROUP] = b;
+}
+
+/* slot of k, whose hash is h, or HM_NONE */
+static inline size_t
+hm__find_h(HmCore const *c, void const *k, size_t ksize, uint64_t h)
+{
+	size_t mask = c->cap - 1, pos = (size_t)(h >> 7) & mask, step = 0;
+	unsigned char h2 = (unsigned char)(h & 0x7F);
+
+	if (!c->len)
+		return HM_NONE;
+
+	/* triangular probing over the groups visits every slot, since cap
+	 * is a power of two */
+	for (;;) {
+		unsigned m = hm__match(c->ctrl + pos, h2);
+		for (; m; m &= m - 1) {
+			size_t i = (pos + hm__ctz(m)) & mask;
+			if (!memcmp((char const *)c->keys + i * ksize, k, ksize))
+				return i;
+		}
+		if (hm__match(c->ctrl + pos, HM_EMPTY))
+			return HM_NONE;
+		step += HM_GROUP;
+		pos = (pos + step) & mask;
+	}
+}
+
+static inline size_t
+hm__find(HmCore const *c, void const *k, size_t ksize)
+{
+	return c->len ? hm__find_h(c, k, ksize, hm_hash(k, ksize)) : HM_NONE;
+}
+
+/* first empty or deleted slot on the probe sequence of h */
+static inline size_t
+hm__find_free(HmCore const *c, uint64_t h)
+{
+	size_t mask = c->cap - 1, pos = (size_t)(h >> 7) & mask, step = 0;
+	unsigned m;
+	while (!(m = hm__match_free(c->ctrl + pos))) {
+		step += HM_GROUP;
+		pos = (pos + step) & mask;
+	}
+	return (pos + hm__ctz(m)) & mask;
+}
+
+static inline void
+hm__rehash(HmCore *c, size_t cap, size_t ksize, size_t vsize)
+{
+	HmCore old = *c;
+	size_t i;
+
+	/* one allocation: keys, values and the control bytes, the values are
+	 * sufficiently aligned since cap is a multiple of 16 */
+	c->keys = hm_malloc(cap * (ksize + vsize + 1) + HM_GROUP);
+	c->vals = (char *)c->keys + cap * ksize;
+	c->ctrl = (unsigned char *)c->vals + cap * vsize;
+	memset(c->ctrl, HM_EMPTY, cap + HM_GROUP);
+	c->cap = cap;
+	c->left = cap - cap / 8 - c->len;
+
+	for (i = 0; i < old.cap; ++i) {
+		if (old.ctrl[i] < HM_EMPTY) {
+			void const *k = (char const *)old.keys + i * ksize;
+			uint64_t h = hm_hash(k, ksize);
+			size_t j = hm__find_free(c, h);
+			hm__setctrl(c, j, (unsigned char)(h & 0x7F));
+			memcpy((char *)c->keys + j * ksize, k, ksize);
+			memcpy((char *)c->vals + j * vsize,
+			       (char const *)old.vals + i * vsize, vsize);
+		}
+	}
+	if (old.cap)
+		hm_dealloc(old.keys);
+}
+
+/* returns the slot of k, which is inserted if it isn't already present */
+static inline size_t
+hm__insert(HmCore *c, void const *k, size_t ksize, size_t vsize)
+{
+	uint64_t h = hm_hash(k, ksize);
+	size_t i = hm__find_h(c, k, ksize, h);
+
+	if (i != HM_NONE)
+		return i;
+
+	i = c->cap ? hm__find_free(c, h) : 0;
+	if (!c->cap || (!c->left && c->ctrl[i] == HM_EMPTY)) {
+		/* grow, or just get rid of the tombstones if there are many */
+		size_t max = c->cap - c->cap / 8;
+		hm__rehash(c, !c->cap ? HM_GROUP :
+		              c->len < max / 2 ? c->cap : c->cap * 2,
+		           ksize, vsize);
+		i = hm__find_free(c, h);
+	}
+
+	c->left -= c->ctrl[i] == HM_EMPTY;
+	++c->len;
+	hm__setctrl(c, i, (unsigned char)(h & 0x7F));
+	memcpy((char *)c->keys + i * ksize, k, ksize);
+	return i;
+}
+
+static inline int
+hm__del(HmCore *c, void const *k, size_t ksize)
+{
+	size_t i = hm__find(c, k, ksize), mask = c->cap - 1;
+	unsigned before, after;
+
+	if (i == HM_NONE)
+		return 0;
+
+	/* If there is no window of HM_GROUP full slots containing i, then no
+	 * probe sequence could have skipped over i, so it can become empty
+	 * again instead of a tombstone. */
+	before = hm__match(c->ctrl + ((i - HM_GROUP) & mask), HM_EMPTY);
+	after = hm__match(c->ctrl + i, HM_EMPTY);
+	if (before && after) {
+		unsigned lead = 0;
+		while (!(before & (1u << (HM_GROUP - 1 - lead))))
+			++lead;
+		if (lead + hm__ctz(after) < HM_GROUP) {
+			hm__setctrl(c, i, HM_EMPTY);
+			++c->left;
+			--c->len;
+			return 1;
+		}
+	}
+	hm__setctrl(c, i, HM_DELETED);
+	--c->len;
+	return 1;
+}
+
+static inline void
+hm__reserve(HmCore *c, size_t n, size_t ksize, size_t vsize)
+{
+	size_t cap = c->cap ? c->cap : HM_GROUP;
+	while (n > cap - cap / 8)
+		cap *= 2;
+	if (cap != c->cap)
+		hm__rehash(c, cap, ksize, vsize);
+}
+
+
+#ifdef __cplusplus
+# define hm__CAST(p,v) ((decltype(p))(v))
+#else
+# define hm__CAST(p,v) (v)
+#endif
+#define hm__SYNC(m) ((m)->keys = hm__CAST((m)->keys, (m)->_c.keys), \
+                     (m)->vals = hm__CAST((m)->vals, (m)->_c.vals))
+
+
+/* can be zero initialized */
+#define Hm(K,V) struct { K *keys; V *vals; HmCore _c; K _k; size_t _i; }
+
+#define hm_len(m) (+(m)._c.len)
+#define hm_cap(m) (+(m)._c.cap)
+
+/* iterate over i in [0,hm_cap) and access keys[i] and vals[i] if occupied */
+#define hm_occupied(m,i) ((m)._c.ctrl[i] < HM_EMPTY)
+
+/* inserts or overwrites the value of k */
+#define hm_put(m,k,v) \
+		((m)->_k = (k), \
+		 (m)->_i = hm__insert(&(m)->_c, &(m)->_k, \
+		                      sizeof *(m)->keys, sizeof *(m)->vals), \
+		 hm__SYNC(m), (m)->vals[(m)->_i] = (v))
+
+/* returns a pointer to the value of k, or 0 if it isn't present */
+#define hm_get(m,k) \
+		((m)->_k = (k), \
+		 (m)->_i = hm__find(&(m)->_c, &(m)->_k, sizeof *(m)->keys), \
+		 (m)->_i == HM_NONE ? 0 : (m)->vals + (m)->_i)
+#define hm_has(m,k) (hm_get((m), (k)) != 0)
+
+/* returns a pointer to the value of k, which is inserted uninitialized if it
+ * isn't already present */
+#define hm_emplace(m,k) \
+		((m)->_k = (k), \
+		 (m)->_i = hm__insert(&(m)->_c, &(m)->_k, \
+		                      sizeof *(m)->keys, sizeof *(m)->vals), \
+		 hm__SYNC(m), (m)->vals + (m)->_i)
+
+/* returns 1 if k was removed and 0 if it wasn't present */
+#define hm_del(m,k) \
+		((m)->_k = (k), hm__del(&(m)->_c, &(m)->_k, sizeof *(m)->keys))
+
+#define hm_reserve(m,n) \
+		(hm__reserve(&(m)->_c, (n), sizeof *(m)->keys, \
+		             sizeof *(m)->vals), hm__SYNC(m))
+
+#define hm_clear(m) \
+		((m)->_c.cap ? (memset((m)->_c.ctrl, HM_EMPTY, \
+		                       (m)->_c.cap + HM_GROUP), \
+		                (m)->_c.left = (m)->_c.cap - (m)->_c.cap / 8) : 0, \
+		 (m)->_c.len = 0)
+
+#define hm_free(m) \
+		((m)->_c.cap ? hm_dealloc((m)->_c.keys), 0 : 0, \
+		 memset(&(m)->_c, 0, sizeof (m)->_c), \
+		 (m)->keys = 0, (m)->vals = 0)
+
+#define HASH_MAP_H_INCLUDED
+#endif
+
+/*
+ * Example:
+ */
+
+#ifdef HASH_MAP_EXAMPLE
+
+#include <stdio.h>
+
+int
+main(void)
+{
+	size_t i;
+	Hm(int, double) m = { 0 };
+
+	for (i = 0; i < 100; ++i)
+		hm_put(&m, (int)i, i * 0.5);
+	hm_del(&m, 42);
+
+	for (i = 0; i < hm_cap(m); ++i)
+		if (hm_occupied(m, i))
+			printf("%d: %f\n", m.keys[i], m.vals[i]);
+
+	hm_free(&m);
+	return 0;
+}
+
+#endif /* HASH_MAP_EXAMPLE */
+
+
+/*
+ * Copyright (c) 2022 Olaf Berstein
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
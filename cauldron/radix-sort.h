@@ -0,0 +1,281 @@
+/* radix-sort.h -- LSD radix sort for fixed width keys
+ * Olaf Bernstein <camel-cdr@protonmail.com>
+ * Distributed under the MIT license, see license at the end of the file.
+ * New versions available at https://github.com/camel-cdr/cauldron
+ *
+ * Stable least significant digit radix sort with 8-bit digits:
+ *
+ *   void rs_u32(uint32_t *a, uint32_t *tmp, size_t n);
+ *   void rs_u64(uint64_t *a, uint64_t *tmp, size_t n);
+ *   void rs_kv32(RsKv32 *a, RsKv32 *tmp, size_t n);
+ *   void rs_kv64(RsKv64 *a, RsKv64 *tmp, size_t n);
+ *
+ * tmp must have room for n elements, or be 0, in which case it's allocated
+ * with rs_malloc. The sorted result always ends up in a.
+ *
+ * RS_DEFINE(name, T, K, KEY) defines a sort function for any other element
+ * type T, where KEY(x) yields an unsigned key of type K. Signed integers and
+ * floats can be sorted by mapping them to an order preserving unsigned key,
+ * e.g. KEY(x) = (uint32_t)x ^ 0x80000000 for int32_t.
+ *
+ * The histograms of all digits are counted in a single pass over the input,
+ * and passes in which all keys have the same digit are skipped. The scatter
+ * goes through a small per-digit buffer of one cache line, which is flushed
+ * with a single memcpy once full (software write-combining). This turns the
+ * 256 interleaved output streams into full cache line writes.
+ *
+ * Define RS_THREADS to a value larger than one before including this header to
+ * split arrays of at least RS_MT_MIN elements into RS_THREADS chunks, that are
+ * counted and scattered by separate pthreads with per-thread histograms.
+ *
+ * If stretchy-buffer.h was included before this header, sb_radix_sort(&a)
+ * sorts an Sb(uint32_t) or Sb(uint64_t).
+ */
+
+#ifndef RADIX_SORT_H_INCLUDED
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef RS_THREADS
+#define RS_THREADS 1
+#endif
+#ifndef RS_MT_MIN
+#define RS_MT_MIN (1024*256)
+#endif
+#define RS_WC_BYTES 64
+
+/* by default: exit on allocation failure, like stretchy-buffer.h */
+
+#ifndef rs_malloc
+static inline void *
+rs__malloc(size_t num_bytes)
+{
+	void *ptr;
+	if (!(ptr = malloc(num_bytes)))
+		perror("malloc failed"), exit(EXIT_FAILURE);
+	return ptr;
+}
+#define rs_malloc(s) rs__malloc(s)
+#endif
+#ifndef rs_dealloc
+#define rs_dealloc(p) free(p)
+#endif
+
+#if RS_THREADS > 1
+#include <pthread.h>
+/* runs fn on RS_THREADS consecutive contexts of the given size */
+static inline void
+rs__parallel(void *(*fn)(void *), void *ctx, size_t size)
+{
+	pthread_t t[RS_THREADS];
+	int started[RS_THREADS];
+	size_t i;
+	/* fall back to running the chunk on this thread */
+	for (i = 1; i < RS_THREADS; ++i)
+		if (!(started[i] = !pthread_create(t + i, 0, fn,
+		                                   (char *)ctx + i * size)))
+			fn((char *)ctx + i * size);
+	fn(ctx);
+	for (i = 1; i < RS_THREADS; ++i)
+		if (started[i])
+			pthread_join(t[i], 0);
+}
+#else
+static inline void
+rs__parallel(void *(*fn)(void *), void *ctx, size_t size)
+{
+	size_t i;
+	for (i = 0; i < RS_THREADS; ++i)
+		fn((char *)ctx + i * size);
+}
+#endif
+
+typedef struct { uint32_t key, val; } RsKv32;
+typedef struct { uint64_t key, val; } RsKv64;
+
+#define RS_DEFINE(name, T, K, KEY) \
+\
+typedef struct { \
+	T const *src; \
+	T *dst; \
+	size_t n, hist[256]; \
+	unsigned shift; \
+} name##__Chunk; \
+\
+static inline void \
+name##__scatter(T const *src, T *dst, size_t n, unsigned shift, size_t *off) \
+{ \
+	enum { WC = sizeof(T) < RS_WC_BYTES ? RS_WC_BYTES / sizeof(T) : 1 }; \
+	T buf[256][WC]; \
+	unsigned char cnt[256] = { 0 }; \
+	size_t i; \
+	unsigned d; \
+	for (i = 0; i < n; ++i) { \
+		d = (unsigned)(KEY(src[i]) >> shift) & 0xFF; \
+		buf[d][cnt[d]++] = src[i]; \
+		if (cnt[d] == WC) { \
+			memcpy(dst + off[d], buf[d], sizeof buf[d]); \
+			off[d] += WC; \
+			cnt[d] = 0; \
+		} \
+	} \
+	for (d = 0; d < 256; ++d) { \
+		memcpy(dst + off[d], buf[d], cnt[d] * sizeof(T)); \
+		off[d] += cnt[d]; \
+	} \
+} \
+\
+static void * \
+name##__count_chunk(void *arg) \
+{ \
+	name##__Chunk *c = (name##__Chunk *)arg; \
+	size_t i; \
+	memset(c->hist, 0, sizeof c->hist); \
+	for (i = 0; i < c->n; ++i) \
+		++c->hist[(KEY(c->src[i]) >> c->shift) & 0xFF]; \
+	return 0; \
+} \
+\
+static void * \
+name##__scatter_chunk(void *arg) \
+{ \
+	name##__Chunk *c = (name##__Chunk *)arg; \
+	name##__scatter(c->src, c->dst, c->n, c->shift, c->hist); \
+	return 0; \
+} \
+\
+/* returns 1 if the pass over the digit at shift wasn't skipped */ \
+static inline int \
+name##__pass_mt(T const *src, T *dst, size_t n, unsigned shift) \
+{ \
+	name##__Chunk c[RS_THREADS]; \
+	size_t i, d, sum = 0; \
+	for (i = 0; i < RS_THREADS; ++i) { \
+		c[i].src = src + n / RS_THREADS * i; \
+		c[i].dst = dst; \
+		c[i].n = i + 1 < RS_THREADS ? n / RS_THREADS : \
+		         n - n / RS_THREADS * i; \
+		c[i].shift = shift; \
+	} \
+	rs__parallel(name##__count_chunk, c, sizeof *c); \
+	/* skip the pass if all keys have the same digit as the first one */ \
+	d = (KEY(src[0]) >> shift) & 0xFF; \
+	for (i = 0; i < RS_THREADS; ++i) \
+		sum += c[i].hist[d]; \
+	if (sum == n) \
+		return 0; \
+	/* turn the per-thread histograms into per-thread output offsets */ \
+	for (sum = d = 0; d < 256; ++d) { \
+		for (i = 0; i < RS_THREADS; ++i) { \
+			size_t t = c[i].hist[d]; \
+			c[i].hist[d] = sum; \
+			sum += t; \
+		} \
+	} \
+	rs__parallel(name##__scatter_chunk, c, sizeof *c); \
+	return 1; \
+} \
+\
+static inline void \
+name(T *a, T *tmp, size_t n) \
+{ \
+	size_t hist[sizeof(K)][256], i, p; \
+	T *src = a, *dst = tmp, *t; \
+	if (n < 2) \
+		return; \
+	if (!tmp) \
+		dst = (T *)rs_malloc(n * sizeof *a); \
+	if (RS_THREADS > 1 && n >= RS_MT_MIN) { \
+		for (p = 0; p < sizeof(K); ++p) \
+			if (name##__pass_mt(src, dst, n, (unsigned)p * 8)) \
+				t = src, src = dst, dst = t; \
+	} else { \
+		memset(hist, 0, sizeof hist); \
+		for (i = 0; i < n; ++i) { \
+			K k = KEY(a[i]); \
+			for (p = 0; p < sizeof(K); ++p) \
+				++hist[p][(k >> p * 8) & 0xFF]; \
+		} \
+		for (p = 0; p < sizeof(K); ++p) { \
+			size_t sum = 0, cnt, d; \
+			if (hist[p][(KEY(a[0]) >> p * 8) & 0xFF] == n) \
+				continue; \
+			for (d = 0; d < 256; ++d) \
+				cnt = hist[p][d], hist[p][d] = sum, sum += cnt; \
+			name##__scatter(src, dst, n, (unsigned)p * 8, hist[p]); \
+			t = src, src = dst, dst = t; \
+		} \
+	} \
+	if (src != a) \
+		memcpy(a, src, n * sizeof *a); \
+	if (!tmp) \
+		rs_dealloc(src != a ? src : dst); \
+}
+
+#define rs__KEY(x) (x)
+#define rs__KEY_KV(x) ((x).key)
+
+RS_DEFINE(rs_u32, uint32_t, uint32_t, rs__KEY)
+RS_DEFINE(rs_u64, uint64_t, uint64_t, rs__KEY)
+RS_DEFINE(rs_kv32, RsKv32, uint32_t, rs__KEY_KV)
+RS_DEFINE(rs_kv64, RsKv64, uint64_t, rs__KEY_KV)
+
+#define RADIX_SORT_H_INCLUDED
+#endif
+
+#if defined(STRETCHY_BUFFER_H_INCLUDED) && !defined(sb_radix_sort)
+/* sorts an Sb(uint32_t) or Sb(uint64_t) */
+#include <assert.h>
+#define sb_radix_sort(a) \
+	(assert(sizeof *(a)->at == 4 || sizeof *(a)->at == 8), \
+	 sizeof *(a)->at == 4 ? \
+	 rs_u32((uint32_t *)(void *)(a)->at, 0, (a)->_len) : \
+	 rs_u64((uint64_t *)(void *)(a)->at, 0, (a)->_len))
+#endif
+
+/*
+ * Example:
+ */
+
+#ifdef RADIX_SORT_EXAMPLE
+
+#include <stdio.h>
+
+int
+main(void)
+{
+	size_t i;
+	uint32_t a[] = { 170, 45, 75, 90, 802, 24, 2, 66 }, tmp[8];
+
+	rs_u32(a, tmp, 8);
+	for (i = 0; i < 8; ++i)
+		printf("%u\n", (unsigned)a[i]);
+
+	return 0;
+}
+
+#endif /* RADIX_SORT_EXAMPLE */
+
+
+/*
+ * Copyright (c) 2022 Olaf Berstein
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
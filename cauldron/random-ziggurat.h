@@ -0,0 +1,640 @@
+/* random-ziggurat.h -- precomputed ziggurat tables for random.h
+ * Generated by tools/random/ziggurat-constants.c -t
+ *
+ * Include this after random.h to use dist_normal(f)_zig_static, which
+ * doesn't need a DistNormal(f)Zig object or a call to dist_normal(f)_zig_init.
+ * Tables are provided for DIST_NORMALF_ZIG_COUNT 32/64/128 and
+ * DIST_NORMAL_ZIG_COUNT 128/256/512/1024, DIST_NORMAL(F)_ZIG_R and
+ * DIST_NORMAL(F)_ZIG_AREA must match DIST_NORMAL(F)_ZIG_TABLE_R and
+ * DIST_NORMAL(F)_ZIG_TABLE_AREA of the selected table. This is checked at
+ * compile time with C11 or C++11, and by an assertion in the functions
+ * below otherwise. */
+
+#ifndef RANDOM_ZIGGURAT_H_INCLUDED
+
+#include <assert.h>
+
+#if DIST_NORMALF_ZIG_COUNT == 32
+# define DIST_NORMALF_ZIG_TABLE_R     2.96130012126401925918f
+# define DIST_NORMALF_ZIG_TABLE_AREA  0.0407587444322198837486f
+static DistNormalfZig const distNormalfZigStatic = {{
+	3.26926219f, 2.96130012f, 2.69844808f, 2.52429467f,
+	2.39009649f, 2.27880753f, 2.18238282f, 2.09635217f,
+	2.01795606f, 1.94535851f, 1.87726613f, 1.81272447f,
+	1.75100066f, 1.69151143f, 1.6337764f, 1.57738639f,
+	1.52198047f, 1.4672285f, 1.41281659f, 1.35843392f,
+	1.30375945f, 1.24844679f, 1.19210538f, 1.13427477f,
+	1.07438674f, 1.0117056f, 0.945227268f, 0.873494471f,
+	0.79422296f, 0.703435973f, 0.593006359f, 0.440608404f,
+	0.0f,
+}};
+#elif DIST_NORMALF_ZIG_COUNT == 64
+# define DIST_NORMALF_ZIG_TABLE_R     3.21365762715889547937f
+# define DIST_NORMALF_ZIG_TABLE_AREA  0.0200244571573516940789f
+static DistNormalfZig const distNormalfZigStatic = {{
+	3.50081843f, 3.21365763f, 2.97554755f, 2.82144173f,
+	2.70489844f, 2.60989649f, 2.52893818f, 2.45788839f,
+	2.39421524f, 2.33625117f, 2.282837f, 2.23313255f,
+	2.18650832f, 2.14247957f, 2.10066446f, 2.06075629f,
+	2.02250456f, 1.9857016f, 1.95017297f, 1.9157704f,
+	1.88236648f, 1.84985059f, 1.81812583f, 1.78710646f,
+	1.75671605f, 1.72688581f, 1.69755336f, 1.66866161f,
+	1.64015794f, 1.61199336f, 1.58412192f, 1.55650011f,
+	1.52908636f, 1.50184056f, 1.47472368f, 1.44769732f,
+	1.4207233f, 1.39376333f, 1.36677852f, 1.33972899f,
+	1.3125734f, 1.28526842f, 1.25776808f, 1.23002318f,
+	1.20198034f, 1.17358111f, 1.14476065f, 1.11544627f,
+	1.08555543f, 1.05499325f, 1.02364918f, 0.991392569f,
+	0.958066565f, 0.923479556f, 0.887392829f, 0.849502158f,
+	0.80940931f, 0.766575851f, 0.720243901f, 0.669289994f,
+	0.611928516f, 0.545024f, 0.462137341f, 0.345538575f,
+	0.0f,
+}};
+#elif DIST_NORMALF_ZIG_COUNT == 128
+# define DIST_NORMALF_ZIG_TABLE_R     3.44261985589665212145f
+# define DIST_NORMALF_ZIG_TABLE_AREA  0.00991256303533646108258f
+static DistNormalfZig const distNormalfZigStatic = {{
+	3.71308625f, 3.44261986f, 3.22308498f, 3.08322886f,
+	2.97869625f, 2.89434401f, 2.82312535f, 2.76116937f,
+	2.70611357f, 2.65640641f, 2.61097225f, 2.56903363f,
+	2.53000967f, 2.49345452f, 2.45901818f, 2.42642065f,
+	2.39543428f, 2.36587137f, 2.33757524f, 2.31041368f,
+	2.28427406f, 2.25905957f, 2.2346864f, 2.21108141f,
+	2.18818043f, 2.16592679f, 2.14427018f, 2.12316571f,
+	2.10257314f, 2.08245624f, 2.06278227f, 2.04352154f,
+	2.02464697f, 2.00613387f, 1.98795957f, 1.97010326f,
+	1.95254573f, 1.93526923f, 1.9182573f, 1.90149465f,
+	1.88496704f, 1.86866114f, 1.85256451f, 1.83666546f,
+	1.820953f, 1.80541676f, 1.79004698f, 1.7748344f,
+	1.75977022f, 1.74484613f, 1.73005416f, 1.71538674f,
+	1.70083662f, 1.68639685f, 1.67206075f, 1.65782192f,
+	1.64367416f, 1.62961148f, 1.6156281f, 1.60171838f,
+	1.58787686f, 1.57409822f, 1.56037722f, 1.54670878f,
+	1.53308788f, 1.51950958f, 1.50596904f, 1.49246142f,
+	1.47898198f, 1.46552596f, 1.45208864f, 1.43866532f,
+	1.42525125f, 1.41184171f, 1.39843191f, 1.38501704f,
+	1.3715922f, 1.35815245f, 1.34469275f, 1.33120795f,
+	1.31769278f, 1.30414185f, 1.29054959f, 1.27691027f,
+	1.26321796f, 1.2494665f, 1.23564948f, 1.22176023f,
+	1.20779175f, 1.19373671f, 1.17958738f, 1.16533564f,
+	1.15097284f, 1.13648985f, 1.12187692f, 1.10712365f,
+	1.09221888f, 1.07715062f, 1.06190596f, 1.0464709f,
+	1.03083024f, 1.0149674f, 0.998864233f, 0.982500804f,
+	0.965855079f, 0.948902625f, 0.931616197f, 0.913965251f,
+	0.895915353f, 0.877427429f, 0.858456843f, 0.838952214f,
+	0.818853907f, 0.798092061f, 0.776583988f, 0.754230664f,
+	0.730911911f, 0.706479611f, 0.680747919f, 0.653478639f,
+	0.624358597f, 0.592962942f, 0.558692178f, 0.520656039f,
+	0.477437837f, 0.426547986f, 0.362871431f, 0.272320865f,
+	0.0f,
+}};
+#else
+# error random-ziggurat.h: no table for DIST_NORMALF_ZIG_COUNT
+#endif
+
+#if DIST_NORMAL_ZIG_COUNT == 128
+# define DIST_NORMAL_ZIG_TABLE_R     3.44261985589665212145
+# define DIST_NORMAL_ZIG_TABLE_AREA  0.00991256303533646108258
+static DistNormalZig const distNormalZigStatic = {{
+	3.7130862467403633, 3.4426198558966521, 3.2230849845786185, 3.0832288582142137,
+	2.978696252645017, 2.8943440070186706, 2.8231253505459664, 2.7611693723841539,
+	2.7061135731187223, 2.6564064112581925, 2.6109722484286132, 2.5690336259216391,
+	2.5300096723854666, 2.4934545220919508, 2.4590181774083501, 2.4264206455302116,
+	2.3954342780074673, 2.3658713701139875, 2.3375752413355307, 2.3104136836950022,
+	2.2842740596736568, 2.2590595738653295, 2.234686395587057, 2.2110814088747278,
+	2.1881804320720206, 2.1659267937448407, 2.1442701823562614, 2.12316570866979,
+	2.1025731351849989, 2.0824562379877246, 2.0627822745039634, 2.0435215366506695,
+	2.0246469733729339, 2.0061338699589668, 1.9879595741230607, 1.9701032608497132,
+	1.9525457295488889, 1.9352692282919002, 1.918257300859732, 1.9014946531003176,
+	1.8849670357028692, 1.868661140989542, 1.8525645117230871, 1.836665460253384,
+	1.8209529965910051, 1.8054167642140487, 1.790046982594619, 1.7748343955807692,
+	1.7597702248942319, 1.7448461281083765, 1.7300541605582435, 1.7153867407081165,
+	1.7008366185643009, 1.6863968467734863, 1.6720607540918522, 1.6578219209482075,
+	1.6436741568569826, 1.6296114794646784, 1.615628095037133, 1.6017183802152771,
+	1.5878768648844007, 1.5740982160167497, 1.5603772223598407, 1.5467087798535035,
+	1.5330878776675561, 1.5195095847593708, 1.5059690368565503, 1.4924614237746154,
+	1.4789819769830979, 1.4655259573357946, 1.4520886428822165, 1.4386653166774613,
+	1.4252512545068616, 1.4118417124397603, 1.3984319141236064, 1.3850170377251486,
+	1.3715922024197323, 1.3581524543224229, 1.344692751745713, 1.3312079496576765,
+	1.317692783201343, 1.3041418501204215, 1.2905495919178732, 1.2769102735516997,
+	1.2632179614460282, 1.2494664995643337, 1.2356494832544812, 1.2217602305309626,
+	1.2077917504067576, 1.1937367078237722, 1.1795873846544607, 1.1653356361550469,
+	1.1509728421389761, 1.1364898520030755, 1.1218769225722541, 1.1071236475235354,
+	1.0922188768965538, 1.0771506248819377, 1.0619059636836194, 1.0464709007525803,
+	1.0308302360564556, 1.0149673952392995, 0.99886423348064351, 0.98250080350276038,
+	0.96585507938813059, 0.94890262549791195, 0.93161619660135381, 0.91396525100880178,
+	0.89591535256623853, 0.87742742909771569, 0.85845684317805086, 0.83895221428120746,
+	0.81885390668331772, 0.7980920606262748, 0.77658398787614839, 0.75423066443451007,
+	0.73091191062188128, 0.70647961131360803, 0.68074791864590422, 0.65347863871504239,
+	0.62435859730908822, 0.59296294244197798, 0.55869217837551797, 0.52065603872514492,
+	0.47743783725378788, 0.42654798630330512, 0.3628714310284183, 0.27232086470466385,
+	0.0,
+}};
+#elif DIST_NORMAL_ZIG_COUNT == 256
+# define DIST_NORMAL_ZIG_TABLE_R     3.65415288536100877227
+# define DIST_NORMAL_ZIG_TABLE_AREA  0.00492867323397465535548
+static DistNormalZig const distNormalZigStatic = {{
+	3.9107579595249159, 3.6541528853610088, 3.4492782985614313, 3.3202447338398255,
+	3.2245750520478016, 3.1478892895180007, 3.0835261320021433, 3.0278377917695935,
+	2.9786032798818432, 2.9343668672088876, 2.8941210536134122, 2.8571387308732246,
+	2.8228773968264429, 2.7909211740019273, 2.7609440052799862, 2.7326853590440114,
+	2.7059336561230622, 2.6805146432857451, 2.6562830375767433, 2.6331163936315828,
+	2.6109105184888237, 2.5895759867082866, 2.5690354526818438, 2.5492215503247831,
+	2.5300752321598542, 2.5115444416266943, 2.4935830412710468, 2.4761499396705232,
+	2.459208374334705, 2.4427253182003642, 2.4266709849371467, 2.4110184139011195,
+	2.3957431197819274, 2.3808227951720856, 2.3662370567172909, 2.3519672273791448,
+	2.3379961487965286, 2.3243080188711325, 2.3108882506013718, 2.2977233489028635,
+	2.2848008027244921, 2.2721089902283819, 2.2596370951737876, 2.2473750329473893,
+	2.2353133849299211, 2.2234433400925106, 2.211756642884161, 2.2002455466112764,
+	2.1889027716263607, 2.177721467740293, 2.1666951803543085, 2.1558178198767375,
+	2.145083634047889, 2.1344871828460169, 2.1240233156895235, 2.1136871506866532,
+	2.1034740557148773, 2.0933796311387919, 2.0833996939983046, 2.073530263518743,
+	2.0637675478117321, 2.0541079316506521, 2.0445479652175315, 2.035084353729619,
+	2.0257139478638542, 2.0164337349062041, 2.0072408305605288, 1.9981324713584197,
+	1.9891060076174381, 1.9801588969004766, 1.9712886979336593, 1.9624930649443631,
+	1.9537697423846468, 1.9451165600086783, 1.9365314282756947, 1.9280123340526657,
+	1.9195573365931881, 1.9111645637712533, 1.9028322085504293, 1.8945585256707047,
+	1.8863418285367828, 1.8781804862929958, 1.8700729210712668, 1.8620176053996741,
+	1.8540130597602019, 1.8460578502851855, 1.8381505865828066, 1.8302899196827569,
+	1.8224745400938858, 1.8147031759662827, 1.8069745913508209, 1.7992875845497202,
+	1.7916409865521626, 1.7840336595494415, 1.7764644955245229, 1.7689324149112686,
+	1.7614363653189103, 1.7539753203176715, 1.7465482782817224, 1.7391542612859117,
+	1.7317923140529632, 1.7244615029480449, 1.7171609150178231, 1.7098896570713018,
+	1.7026468547999232, 1.6954316519345616, 1.6882432094371954, 1.6810807047251739,
+	1.673943330926125, 1.6668302961616655, 1.6597408228581826, 1.6526741470830559,
+	1.6456295179047823, 1.6386061967755477, 1.6316034569348735, 1.6246205828330348,
+	1.6176568695730155, 1.61071162236983, 1.6037841560260945, 1.5968737944227882,
+	1.5899798700241908, 1.5831017233960292, 1.5762387027359063, 1.5693901634151237,
+	1.5625554675310448, 1.5557339834691764, 1.5489250854741734, 1.542128153229002,
+	1.5353425714415141, 1.5285677294377124, 1.521803020760998, 1.5150478427767146,
+	1.5083015962813115, 1.5015636851154637, 1.4948335157804936, 1.4881104970574476,
+	1.4813940396281874, 1.4746835556978556, 1.4679784586180796, 1.4612781625102756,
+	1.4545820818884103, 1.4478896312805761, 1.441200224848724, 1.4345132760058922,
+	1.427828197030256, 1.421144398675309, 1.4144612897754712, 1.4077782768463988,
+	1.401094763679251, 1.394410150928141, 1.387723835689976, 1.3810352110758554,
+	1.3743436657731663, 1.3676485835974762, 1.360949343033283, 1.354245316762635,
+	1.3475358711805872, 1.340820365896404, 1.33409815321936, 1.3273685776279259,
+	1.3206309752210563, 1.3138846731502205, 1.3071289890307311, 1.3003632303308372,
+	1.2935866937369478, 1.2867986644932436, 1.2799984157138179, 1.2731852076653564,
+	1.2663582870182295, 1.2595168860637142, 1.2526602218948972, 1.2457874955486273,
+	1.2388978911056874, 1.2319905747461361, 1.2250646937565308, 1.2181193754854817,
+	1.2111537262436992, 1.2041668301443815, 1.1971577478794416, 1.1901255154266921,
+	1.1830691426826868, 1.1759876120154521, 1.1688798767308331, 1.1617448594456114,
+	1.1545814503599277, 1.1473885054208491, 1.1401648443681512, 1.1329092486525338,
+	1.1256204592155334, 1.118297174119345, 1.1109380460135757, 1.1035416794246397,
+	1.0961066278520214, 1.0886313906539798, 1.0811144097034038, 1.0735540657924363,
+	1.0659486747621225, 1.0582964833306751, 1.0505956645909299, 1.042844313144149,
+	1.0350404398334409, 1.0271819660356458, 1.0192667174654842, 1.0112924174399957,
+	1.003256679544673, 0.99515699963509092, 0.98699074709906247, 0.9787551552942246,
+	0.97044731106422445, 0.96206414322304058, 0.95360240988108603, 0.94505868446816546,
+	0.93642934028657514, 0.92771053340200012, 0.91889818364959061, 0.90998795349671849,
+	0.90097522446122183, 0.89185507073294156, 0.88262222958516555, 0.87327106808886075,
+	0.86379554555330885, 0.8541891710081638, 0.84444495490915392, 0.83455535408638218,
+	0.82451220875229213, 0.81430667013521523, 0.80392911698997122, 0.79336905884062329,
+	0.78261502330723312, 0.77165442422456808, 0.76047340643010803, 0.74905666201781529,
+	0.73738721143429559, 0.72544614090999964, 0.71321228519097595, 0.70066184110681507,
+	0.68776789279578853, 0.67449982283729382, 0.66082257424441973, 0.64669571489499381,
+	0.63207223638606117, 0.61689699000775144, 0.60110461775599262, 0.58461676610637932,
+	0.56733825705381874, 0.54915170232716511, 0.52990972066155811, 0.50942332960209181,
+	0.48744396613923603, 0.46363433679088221, 0.43751840220787167, 0.40838913461199113,
+	0.37512133287838058, 0.33573751921442522, 0.28617459179207249, 0.21524189598488167,
+	0.0,
+}};
+#elif DIST_NORMAL_ZIG_COUNT == 512
+# define DIST_NORMAL_ZIG_TABLE_R     3.85204615036839124759
+# define DIST_NORMAL_ZIG_TABLE_AREA  0.00245676635154135573953
+static DistNormalZig const distNormalZigStatic = {{
+	4.0968586097934827, 3.8520461503683912, 3.6591529330911164, 3.5387147915535359,
+	3.4499415844581948, 3.3791208509098653, 3.319924272752552, 3.2688953201247243,
+	3.2239336074705574, 3.1836646787008854, 3.1471385926519712, 3.1136706092218944,
+	3.0827503897194092, 3.0539870972903128, 3.0270745842754689, 3.0017684330687534,
+	2.9778703072041906, 2.9552169815083583, 2.9336724639032943, 2.9131222169485817,
+	2.8934688401496455, 2.8746287902796272, 2.8565298533366061, 2.839109170018659,
+	2.8223116750508611, 2.8060888502170392, 2.7903977181709911, 2.7752000231739453,
+	2.7604615584754485, 2.7461516098484305, 2.7322424919497175, 2.7187091594759438,
+	2.7055288790496144, 2.6926809507675676, 2.6801464706321721, 2.6679081268478898,
+	2.6559500243346071, 2.6442575328806557, 2.6328171552034775, 2.6216164118569691,
+	2.6106437404609705, 2.5998884071598398, 2.5893404285661339, 2.5789905027294192,
+	2.5688299479025083, 2.5588506480683336, 2.5490450043483498, 2.5394058915441638,
+	2.5299266191730942, 2.5206008964495547, 2.5114228007407585, 2.5023867490898326,
+	2.4934874724540813, 2.4847199923525551, 2.4760795996566162, 2.4675618352909908,
+	2.4591624726417722, 2.450877501492748, 2.4427031133329121, 2.4346356878965929,
+	2.426671780813735, 2.4188081122618657, 2.4110415565234738, 2.403369132363176,
+	2.39578799414837, 2.3882954236452498, 2.38088882242925, 2.3735657048553191,
+	2.3663236915390124, 2.3591605033043417, 2.3520739555587, 2.3450619530590706,
+	2.3381224850371873, 2.3312536206543983, 2.3244535047597318, 2.3177203539271236,
+	2.3110524527499645, 2.3044481503730991, 2.2979058572441794, 2.2914240420678696,
+	2.2850012289478306, 2.2786359947027097, 2.2723269663435255, 2.2660728187008963,
+	2.2598722721915137, 2.2537240907141323, 2.2476270796661295, 2.2415800840724064,
+	2.2355819868190481, 2.2296317069847555, 2.2237281982635985, 2.2178704474731334,
+	2.2120574731423764, 2.2062883241745377, 2.2005620785797949, 2.1948778422737315,
+	2.1892347479373814, 2.1836319539351109, 2.1780686432868369, 2.1725440226913261,
+	2.1670573215975428, 2.1616077913212271, 2.1561947042040695, 2.1508173528130321,
+	2.1454750491775266, 2.1401671240623097, 2.1348929262740997, 2.129651822000045,
+	2.1244431941762954, 2.1192664418850403, 2.1141209797784779, 2.1090062375282789,
+	2.1039216592991946, 2.0988667032455423, 2.0938408410293801, 2.0888435573592524,
+	2.0838743495484545, 2.0789327270918298, 2.0740182112601659, 2.0691303347113164,
+	2.0642686411172195, 2.0594326848060371, 2.0546220304186797, 2.0498362525790223,
+	2.0450749355771602, 2.0403376730650835, 2.0356240677641887, 2.0309337311840735,
+	2.0262662833520941, 2.021621352553189, 2.0169985750795031, 2.0123975949893673,
+	2.0078180638752146, 2.003259640640035, 1.9987219912819901, 1.9942047886868308,
+	1.9897077124277773, 1.985230448572539, 1.9807726894971676, 1.9763341337064515,
+	1.9719144856605762, 1.9675134556077848, 1.9631307594227913, 1.9587661184507046,
+	1.9544192593562404, 1.9500899139780004, 1.9457778191876175, 1.9414827167535663,
+	1.9372043532094561, 1.9329424797266246, 1.9286968519908639, 1.924467230083117,
+	1.9202533783639877, 1.9160550653619177, 1.9118720636648895, 1.907704149815519,
+	1.9035511042094096, 1.8994127109966441, 1.8952887579862965, 1.891179036553851,
+	1.8870833415514195, 1.8830014712206555, 1.8789332271082637, 1.8748784139840128,
+	1.8708368397611575, 1.8668083154191869, 1.8627926549288112, 1.8587896751791113,
+	1.8547991959067708, 1.8508210396273195, 1.8468550315683164, 1.8429009996044052,
+	1.8389587741941765, 1.8350281883187756, 1.8311090774221942, 1.8272012793531899,
+	1.8233046343087771, 1.8194189847792369, 1.815544175494594, 1.811680053372512,
+	1.8078264674675599, 1.8039832689218035, 1.8001503109166781, 1.7963274486261016,
+	1.7925145391707853, 1.7887114415737045, 1.7849180167166913, 1.7811341272981129,
+	1.7773596377916004, 1.7735944144057943, 1.7698383250450752, 1.7660912392712462,
+	1.7623530282661394, 1.7586235647951147, 1.7549027231714249, 1.7511903792214188,
+	1.7474864102505558, 1.7437906950102073, 1.7401031136652208, 1.7364235477622212,
+	1.7327518801986285, 1.7290879951923689, 1.725431778252258, 1.7217831161490343,
+	1.7181418968870262, 1.7145080096764288, 1.7108813449061757, 1.707261794117385,
+	1.7036492499773638, 1.7000436062541523, 1.696444757791593, 1.6928526004849079,
+	1.6892670312567682, 1.6856879480338421, 1.6821152497238058, 1.6785488361928036,
+	1.6749886082433434, 1.6714344675926146, 1.6678863168512151, 1.6643440595022755,
+	1.6608075998809673, 1.6572768431543845, 1.6537516953017864, 1.6502320630951906,
+	1.6467178540803049, 1.6432089765577891, 1.6397053395648339, 1.6362068528570498,
+	1.6327134268906535, 1.6292249728049442, 1.6257414024050602, 1.6222626281450062,
+	1.6187885631109426, 1.6153191210047294, 1.6118542161277144, 1.6083937633647595,
+	1.6049376781684953, 1.6014858765437981, 1.5980382750324798, 1.5945947906981849,
+	1.5911553411114858, 1.587719844335171, 1.5842882189097174, 1.5808603838389411,
+	1.5774362585758194, 1.5740157630084784, 1.5705988174463378, 1.5671853426064083,
+	1.5637752595997354, 1.5603684899179821, 1.5569649554201453, 1.5535645783194007,
+	1.5501672811700688, 1.5467729868546979, 1.543381618571257, 1.5399930998204339,
+	1.5366073543930328, 1.533224306357466, 1.5298438800473341, 1.5264660000490895,
+	1.5230905911897777, 1.5197175785248521, 1.5163468873260558, 1.5129784430693663,
+	1.5096121714229974, 1.5062479982354535, 1.5028858495236314, 1.4995256514609645,
+	1.4961673303656038, 1.4928108126886319, 1.4894560250023045, 1.4861028939883133,
+	1.4827513464260682, 1.4794013091809903, 1.476052709192814, 1.4727054734638911,
+	1.4693595290474926, 1.4660148030361038, 1.4626712225497066, 1.4593287147240453,
+	1.4559872066988694, 1.4526466256061495, 1.4493068985582607, 1.4459679526361285,
+	1.4426297148773315, 1.4392921122641568, 1.4359550717116014, 1.4326185200553153,
+	1.4292823840394803, 1.4259465903046195, 1.4226110653753316, 1.419275735647944,
+	1.4159405273780803, 1.4126053666681344, 1.4092701794546478, 1.4059348914955811,
+	1.4025994283574768, 1.3992637154025044, 1.3959276777753835, 1.392591240390177,
+	1.3892543279169491, 1.3859168647682801, 1.3825787750856321, 1.3792399827255585,
+	1.3759004112457492, 1.3725599838909057, 1.369218623578437, 1.3658762528839699,
+	1.3625327940266654, 1.3591881688543321, 1.3558422988283305, 1.3524951050082579,
+	1.349146508036405, 1.3457964281219778, 1.3424447850250714, 1.3390914980403911,
+	1.3357364859807063, 1.3323796671600313, 1.3290209593765195, 1.3256602798950626,
+	1.3222975454295825, 1.3189326721250059, 1.3155655755389076, 1.3121961706228144,
+	1.308824371703153, 1.3054500924618322, 1.3020732459164446, 1.2986937444000756,
+	1.2953114995407034, 1.2919264222401784, 1.2885384226527642, 1.2851474101632264,
+	1.281753293364453, 1.2783559800345888, 1.2749553771136677, 1.2715513906797238,
+	1.2681439259243646, 1.2647328871277857, 1.2613181776332072, 1.2578996998207125,
+	1.2544773550804666, 1.2510510437852929, 1.2476206652625854, 1.2441861177655313,
+	1.2407472984436212, 1.2373041033124196, 1.2338564272225693, 1.2304041638280032,
+	1.2269472055533323, 1.2234854435603822, 1.2200187677138457, 1.2165470665460188,
+	1.2130702272205869, 1.2095881354954267, 1.2061006756843844, 1.202607730617996,
+	1.1991091816031061, 1.1956049083813462, 1.1920947890864287, 1.1885787002002105,
+	1.1850565165074805, 1.1815281110494211, 1.1779933550756928, 1.1744521179950877,
+	1.170904267324697, 1.1673496686375333, 1.163788185508547, 1.1602196794589722,
+	1.1566440098989368, 1.1530610340682651, 1.1494706069754009, 1.1458725813343748,
+	1.1422668074997339, 1.1386531333993515, 1.1350314044650283, 1.1314014635607919,
+	1.1277631509087991, 1.124116304012738, 1.1204607575786249, 1.1167963434328824,
+	1.1131228904375819, 1.1094402244027277, 1.1057481679954507, 1.1020465406459779,
+	1.098335158450232, 1.0946138340689101, 1.0908823766228843, 1.087140591584754,
+	1.083388280666375, 1.0796252417021791, 1.0758512685280875, 1.0720661508558112,
+	1.0682696741423201, 1.0644616194542495, 1.0606417633270015, 1.0568098776182818,
+	1.0529657293558021, 1.0491090805788573, 1.0452396881734747, 1.0413573037008119,
+	1.0374616732184601, 1.0335525370942926, 1.029629629812472, 1.0256926797712092,
+	1.0217414090718413, 1.0177755332987681, 1.0137947612897587, 1.0097987948961083,
+	1.0057873287320922, 1.0017600499131289, 0.99771663778202385, 0.99365676362262741,
+	0.98958009036019242, 0.98548627224767178, 0.98137495453714329, 0.97724577313549377,
+	0.97309835424343433, 0.9689323139768536, 0.96474725796944561, 0.96054278095547277,
+	0.95631846633144232, 0.95207388569538496, 0.94780859836232798, 0.94352215085444959,
+	0.93921407636428721, 0.93488389418924774, 0.93053110913553287, 0.92615521088944445,
+	0.92175567335387426, 0.91733195394760655, 0.91288349286486953, 0.90840971229236151,
+	0.90391001558074721, 0.89938378636736689, 0.89483038764662324, 0.89024916078420653,
+	0.88563942447098231, 0.8810004736119964, 0.87633157814564387, 0.87163198178759812,
+	0.86690090069359741, 0.86213752203463459, 0.85734100247748309, 0.85251046656281246,
+	0.84764500497239049, 0.84274367267602633, 0.83780548694796916, 0.8328294252414271,
+	0.82781442290869527, 0.82275937075306455, 0.81766311239720275, 0.81252444145103523,
+	0.80734209846027549, 0.80211476761463788, 0.79684107319236702, 0.79151957571500098,
+	0.78614876778319768, 0.78072706956093854, 0.77525282387141245, 0.76972429086329515,
+	0.76413964220087981, 0.75849695472546988, 0.75279420352847998, 0.74702925436864417,
+	0.74119985535640806, 0.73530362781775001, 0.72933805623705431, 0.72330047716390392,
+	0.71718806695135604, 0.71099782817290078, 0.70472657454125687, 0.69837091412365692,
+	0.69192723061436353, 0.68539166238464561, 0.67876007898184342, 0.67202805469058627,
+	0.66519083869832793, 0.65824332132111362, 0.65117999564002286, 0.64399491376906304,
+	0.63668163681495119, 0.62923317738976045, 0.62164193328768471, 0.61389961062239261,
+	0.60599713432177938, 0.59792454336558269, 0.58967086749171696, 0.5812239812388247,
+	0.57257043006502767, 0.56369522178677683, 0.55458157457489262, 0.54521061002124008,
+	0.53556097604563259, 0.52560837919470081, 0.51532499850163811, 0.50467874245534133,
+	0.49363229506874703, 0.48214187377839367, 0.47015558635112076, 0.45761121823148546,
+	0.44443319185881791, 0.43052828972059036, 0.41577947401088, 0.40003666850050174,
+	0.38310248105129541, 0.36470905546562091, 0.34447835352767042, 0.32184890256690196,
+	0.29592714272092494, 0.2651426717479022, 0.22626870482801172, 0.17041758857748684,
+	0.0,
+}};
+#elif DIST_NORMAL_ZIG_COUNT == 1024
+# define DIST_NORMAL_ZIG_TABLE_R     4.03884984610950452822
+# define DIST_NORMAL_ZIG_TABLE_AREA  0.00122632464635308808131
+static DistNormalZig const distNormalZigStatic = {{
+	4.2734453030989947, 4.0388498461095045, 3.8560026549832625, 3.7426132245502857,
+	3.6594095557852236, 3.5932670241568133, 3.538147586277857, 3.4907603559675709,
+	3.4491089090900316, 3.4118885898571882, 3.3781987406232436, 3.3473908035194806,
+	3.3189818442737253, 3.2926023172888973, 3.2679629709643398, 3.244833038270699,
+	3.2230253818266645, 3.2023860872918335, 3.1827869940961559, 3.1641202199453385,
+	3.1462940716254424, 3.1292299404068095, 3.1128599100661437, 3.0971248894572685,
+	3.081973137106744, 3.067359082848151, 3.0532423773554317, 3.0395871185370638,
+	3.0263612166277751, 3.0135358691028396, 3.0010851233287874, 2.9889855098863264,
+	2.9772157332578253, 2.9657564094109023, 2.9545898419762699, 2.9436998303862469,
+	2.9330715046357257, 2.9226911823411699, 2.9125462445725226, 2.9026250275675014,
+	2.8929167279449082, 2.8834113194413977, 2.8740994795260219, 2.8649725245151763,
+	2.8560223520299607, 2.8472413898182606, 2.8386225501127195, 2.8301591888192506,
+	2.8218450689336054, 2.8136743276695606, 2.8056414468545521, 2.7977412262095038,
+	2.7899687591811373, 2.7823194110388111, 2.7747887989852051, 2.767372774062025,
+	2.7600674046591988, 2.7528689614595119, 2.745773903670865, 2.7387788664158301,
+	2.7318806491633494, 2.7250762051005939, 2.7183626313544837, 2.7117371599823913,
+	2.7051971496603253, 2.6987400780045856, 2.6923635344696467, 2.686065213770981,
+	2.6798429097867969, 2.673694509897314, 2.6676179897243177, 2.6616114082373969,
+	2.6556729031965135, 2.6498006869034568, 2.643993042237314, 2.6382483189514019,
+	2.6325649302111689, 2.6269413493544325, 2.6213761068569793, 2.6158677874880508,
+	2.6104150276415862, 2.605016512830306, 2.599670975330818, 2.5943771919689176,
+	2.5891339820351515, 2.5839402053215273, 2.578794760270988, 2.5736965822319424,
+	2.5686446418107498, 2.5636379433156143, 2.5586755232858479, 2.5537564491009255,
+	2.5488798176641737, 2.544044754156324, 2.5392504108545104, 2.5344959660126189,
+	2.5297806227991884, 2.5251036082893382, 2.5204641725074458, 2.5158615875175287,
+	2.5112951465584961, 2.5067641632216313, 2.5022679706678452, 2.4978059208824062,
+	2.4933773839650082, 2.4889817474531761, 2.4846184156771416, 2.4802868091444428,
+	2.4759863639526137, 2.4717165312284322, 2.4674767765922947, 2.4632665796463726,
+	2.4590854334852904, 2.4549328442281418, 2.4508083305707335, 2.4467114233570134,
+	2.4426416651686988, 2.4385986099321859, 2.4345818225418669, 2.4305908784990405,
+	2.4266253635656421, 2.4226848734320685, 2.4187690133984108, 2.4148773980684498,
+	2.4110096510558027, 2.4071654047016442, 2.4033442998034581, 2.3995459853543036,
+	2.395770118292109, 2.3920163632585326, 2.3882843923669533, 2.3845738849791786,
+	2.380884527490478, 2.3772160131225707, 2.3735680417242156, 2.3699403195790696,
+	2.3663325592204984, 2.362744479253037, 2.3591758041802164, 2.3556262642384835,
+	2.3520955952369573, 2.3485835384027748, 2.345089840231795, 2.3416142523444373,
+	2.3381565313464441, 2.3347164386943661, 2.3312937405655782, 2.3278882077326437,
+	2.3244996154418534, 2.3211277432957719, 2.3177723751396348, 2.3144332989514442,
+	2.3111103067356192, 2.3078031944200634, 2.304511761756518, 2.3012358122240755,
+	2.2979751529357325, 2.2947295945478694, 2.2914989511725444, 2.2882830402924993,
+	2.2850816826787758, 2.281894702310846, 2.2787219262991659, 2.2755631848100631,
+	2.2724183109928753, 2.269287140909258, 2.2661695134645846, 2.2630652703413646,
+	2.2599742559346081, 2.2568963172890702, 2.2538313040383073, 2.2507790683454849,
+	2.2477394648458751, 2.2447123505909871, 2.241697584994274, 2.2386950297783633,
+	2.2357045489237602, 2.232726008618973, 2.2297592772120158, 2.2268042251632398,
+	2.2238607249994523, 2.2209286512692796, 2.2180078804997346, 2.2150982911539484,
+	2.2121997635900307, 2.2093121800210208, 2.2064354244758962, 2.2035693827616038,
+	2.2007139424260831, 2.1978689927222489, 2.1950344245729047, 2.1922101305365571,
+	2.1893960047741042, 2.1865919430163711, 2.1837978425324655, 2.1810136020989309,
+	2.1782391219696705, 2.1754743038466208, 2.172719050851152, 2.1699732674961724,
+	2.1672368596589181, 2.1645097345544056, 2.1617918007095299, 2.1590829679377875,
+	2.1563831473146077, 2.1536922511532736, 2.1510101929814166, 2.148336887518067,
+	2.1456722506512466, 2.1430161994160858, 2.1403686519734525, 2.1377295275890769,
+	2.1350987466131592, 2.1324762304604464, 2.1298619015907661, 2.1272556834900028,
+	2.124657500651507, 2.1220672785579235, 2.1194849436634283, 2.1169104233763629,
+	2.1143436460422558, 2.1117845409272195, 2.1092330382017145, 2.1066890689246701,
+	2.104152565027952, 2.1016234593011683, 2.0991016853768046, 2.0965871777156802,
+	2.0940798715927158, 2.0915797030830069, 2.0890866090481924, 2.0866005271231129,
+	2.0841213957027498, 2.0816491539294403, 2.0791837416803576, 2.0767250995552543,
+	2.074273168864458, 2.0718278916171161, 2.0693892105096815, 2.0669570689146346,
+	2.064531410869435, 2.0621121810656972, 2.0596993248385857, 2.0572927881564233,
+	2.0548925176105075, 2.0524984604051304, 2.0501105643477974, 2.0477287778396387,
+	2.0453530498660104, 2.0429833299872803, 2.0406195683297935, 2.0382617155770139,
+	2.0359097229608381, 2.0335635422530763, 2.031223125757098, 2.0288884262996368,
+	2.0265593972227524, 2.0242359923759451, 2.0219181661084196, 2.0196058732614945,
+	2.017299069161155, 2.0149977096107442, 2.012701750883791, 2.0104111497169712,
+	2.0081258633031984, 2.0058458492848428, 2.0035710657470736, 2.0013014712113235,
+	1.9990370246288725, 1.9967776853745475, 1.994523413240536, 1.9922741684303112,
+	1.9900299115526657, 1.9877906036158521, 1.985556206021828, 1.9833266805606022,
+	1.9811019894046818, 1.9788820951036163, 1.9766669605786371, 1.9744565491173918,
+	1.9722508243687688, 1.9700497503378118, 1.9678532913807233, 1.9656614121999523,
+	1.9634740778393676, 1.9612912536795124, 1.9591129054329412, 1.9569389991396335,
+	1.9547695011624874, 1.9526043781828871, 1.9504435971963455, 1.9482871255082202,
+	1.9461349307294992, 1.9439869807726584, 1.9418432438475858, 1.9397036884575744,
+	1.9375682833953792, 1.9354369977393404, 1.9333098008495681, 1.9311866623641902,
+	1.9290675521956602, 1.9269524405271248, 1.92484129780885, 1.9227340947547038,
+	1.9206308023386956, 1.9185313917915704, 1.9164358345974566, 1.9143441024905672,
+	1.9122561674519522, 1.9101720017063027, 1.9080915777188041, 1.906014868192039,
+	1.9039418460629369, 1.9018724844997728, 1.8998067568992103, 1.8977446368833908,
+	1.8956860982970676, 1.8936311152047826, 1.891579661888087, 1.8895317128428029,
+	1.8874872427763272, 1.8854462266049754, 1.8834086394513652, 1.8813744566418392,
+	1.8793436537039264, 1.87731620636384, 1.8752920905440137, 1.8732712823606732,
+	1.8712537581214436, 1.8692394943229917, 1.8672284676487029, 1.8652206549663914,
+	1.8632160333260437, 1.8612145799575944, 1.8592162722687346, 1.8572210878427507,
+	1.8552290044363946, 1.8532399999777841, 1.8512540525643331, 1.8492711404607105,
+	1.8472912420968285, 1.8453143360658584, 1.843340401122275, 1.8413694161799268,
+	1.8394013603101349, 1.837436212739816, 1.8354739528496332, 1.8335145601721705,
+	1.8315580143901339, 1.8296042953345753, 1.827653382983142, 1.825705257458349,
+	1.8237598990258748, 1.82181728809288, 1.8198774052063491, 1.817940231051453,
+	1.816005746449935, 1.8140739323585164, 1.8121447698673249, 1.8102182401983419,
+	1.8082943247038718, 1.80637300486503, 1.8044542622902514, 1.8025380787138177,
+	1.8006244359944038, 1.7987133161136435, 1.7968047011747126, 1.7948985734009308,
+	1.7929949151343812, 1.7910937088345475, 1.7891949370769677, 1.7872985825519059,
+	1.7854046280630394, 1.7835130565261635, 1.7816238509679116, 1.7797369945244913,
+	1.7778524704404363, 1.7759702620673735, 1.7740903528628055, 1.7722127263889072,
+	1.7703373663113383, 1.7684642563980686, 1.7665933805182192, 1.7647247226409161,
+	1.7628582668341585, 1.7609939972637002, 1.7591318981919445, 1.7572719539768518,
+	1.7554141490708604, 1.7535584680198203, 1.7517048954619384, 1.749853416126737,
+	1.748004014834024, 1.7461566764928749, 1.7443113861006266, 1.7424681287418831,
+	1.7406268895875314, 1.7387876538937701, 1.7369504070011477, 1.7351151343336125,
+	1.733281821397573, 1.7314504537809682, 1.7296210171523492, 1.7277934972599702,
+	1.72596787993089, 1.7241441510700828, 1.7223222966595592, 1.7205023027574968,
+	1.7186841554973795, 1.7168678410871469, 1.7150533458083523, 1.7132406560153299,
+	1.7114297581343708, 1.7096206386629075, 1.7078132841687072, 1.7060076812890738,
+	1.7042038167300572, 1.7024016772656721, 1.7006012497371239, 1.698802521052043,
+	1.6970054781837266, 1.6952101081703884, 1.6934163981144158, 1.6916243351816349,
+	1.6898339066005818, 1.6880450996617826, 1.6862579017170394, 1.6844723001787236,
+	1.6826882825190765, 1.680905836269516, 1.6791249490199505, 1.6773456084180997,
+	1.6755678021688205, 1.6737915180334412, 1.6720167438291004, 1.6702434674280931,
+	1.6684716767572221, 1.6667013597971563, 1.664932504581794, 1.6631650991976329,
+	1.6613991317831447, 1.659634590528157, 1.6578714636732386, 1.6561097395090926,
+	1.6543494063759529, 1.6525904526629871, 1.6508328668077044, 1.6490766372953684,
+	1.6473217526584154, 1.645568201475877, 1.6438159723728084, 1.6420650540197206,
+	1.6403154351320184, 1.6385671044694422, 1.6368200508355146, 1.6350742630769919,
+	1.6333297300833196, 1.6315864407860924, 1.6298443841585187, 1.6281035492148888,
+	1.6263639250100482, 1.6246255006388738, 1.6228882652357554, 1.6211522079740799,
+	1.6194173180657205, 1.6176835847605289, 1.6159509973458319, 1.6142195451459311,
+	1.6124892175216069, 1.6107600038696255, 1.6090318936222497, 1.6073048762467533,
+	1.6055789412449384, 1.6038540781526567, 1.6021302765393334, 1.6004075260074949,
+	1.5986858161922993, 1.5969651367610703, 1.595245477412834, 1.5935268278778582,
+	1.5918091779171959, 1.5900925173222303, 1.5883768359142237, 1.5866621235438686,
+	1.5849483700908413, 1.5832355654633594, 1.5815236995977402, 1.5798127624579632,
+	1.5781027440352341, 1.576393634347552, 1.5746854234392782, 1.5729781013807085,
+	1.5712716582676468, 1.5695660842209815, 1.5678613693862638, 1.5661575039332887,
+	1.5644544780556778, 1.562752281970464, 1.5610509059176788, 1.559350340159941,
+	1.5576505749820476, 1.555951600690567, 1.5542534076134333, 1.552555986099543,
+	1.5508593265183534, 1.5491634192594824, 1.5474682547323103, 1.5457738233655832,
+	1.544080115607018, 1.5423871219229088, 1.5406948327977349, 1.5390032387337705,
+	1.5373123302506956, 1.535622097885208, 1.5339325321906375, 1.5322436237365605,
+	1.5305553631084163, 1.5288677409071248, 1.5271807477487048, 1.5254943742638941,
+	1.5238086110977704, 1.5221234489093731, 1.5204388783713262, 1.5187548901694626,
+	1.5170714750024488, 1.515388623581411, 1.5137063266295612, 1.5120245748818253,
+	1.5103433590844711, 1.5086626699947376, 1.5069824983804642, 1.505302835019722,
+	1.5036236707004439, 1.5019449962200569, 1.5002668023851143, 1.4985890800109279,
+	1.4969118199212015, 1.4952350129476649, 1.4935586499297072, 1.4918827217140116,
+	1.4902072191541901, 1.4885321331104186, 1.4868574544490718, 1.4851831740423588,
+	1.4835092827679588, 1.4818357715086569, 1.4801626311519797, 1.4784898525898312,
+	1.4768174267181291, 1.4751453444364402, 1.4734735966476163, 1.4718021742574304,
+	1.4701310681742115, 1.4684602693084807, 1.4667897685725858, 1.4651195568803368,
+	1.4634496251466401, 1.4617799642871329, 1.4601105652178172, 1.4584414188546932,
+	1.4567725161133924, 1.4551038479088103, 1.4534354051547381, 1.4517671787634945,
+	1.4500991596455563, 1.4484313387091887, 1.4467637068600748, 1.4450962550009442,
+	1.4434289740312012, 1.441761854846552, 1.4400948883386306, 1.4384280653946247,
+	1.4367613768968998, 1.4350948137226228, 1.4334283667433848, 1.4317620268248216,
+	1.4300957848262351, 1.4284296316002114, 1.4267635579922394, 1.4250975548403271,
+	1.4234316129746173, 1.4217657232170012, 1.4200998763807315, 1.4184340632700335,
+	1.4167682746797148, 1.4151025013947737, 1.4134367341900058, 1.4117709638296093,
+	1.4101051810667883, 1.4084393766433545, 1.4067735412893272, 1.4051076657225318,
+	1.4034417406481958, 1.4017757567585435, 1.4001097047323884, 1.3984435752347237,
+	1.3967773589163109, 1.395111046413266, 1.393444628346644, 1.3917780953220206,
+	1.3901114379290724, 1.3884446467411537, 1.3867777123148724, 1.3851106251896622,
+	1.3834433758873527, 1.3817759549117375, 1.3801083527481392, 1.3784405598629714,
+	1.3767725667032993, 1.3751043636963959, 1.3734359412492967, 1.3717672897483506,
+	1.3700983995587689, 1.3684292610241698, 1.3667598644661217, 1.3650902001836816,
+	1.3634202584529314, 1.3617500295265108, 1.3600795036331465, 1.3584086709771782,
+	1.3567375217380817, 1.3550660460699872, 1.3533942341011955, 1.3517220759336895,
+	1.3500495616426424, 1.3483766812759217, 1.3467034248535903, 1.3450297823674024,
+	1.3433557437802962, 1.3416812990258822, 1.3400064380079275, 1.3383311505998356,
+	1.3366554266441223, 1.3349792559518865, 1.3333026283022772, 1.3316255334419556,
+	1.3299479610845525, 1.328269900910121, 1.3265913425645844, 1.3249122756591795,
+	1.323232689769894, 1.3215525744368998, 1.3198719191639806, 1.3181907134179542,
+	1.3165089466280895, 1.3148266081855183, 1.3131436874426407, 1.3114601737125261,
+	1.3097760562683072, 1.3080913243425689, 1.3064059671267308, 1.3047199737704238,
+	1.3030333333808605, 1.3013460350221996, 1.2996580677149027, 1.2979694204350865,
+	1.2962800821138662, 1.2945900416366943, 1.2928992878426904, 1.2912078095239659,
+	1.2895155954249401, 1.2878226342416499, 1.2861289146210519, 1.284434425160317,
+	1.2827391544061172, 1.2810430908539047, 1.2793462229471835, 1.2776485390767722,
+	1.2759500275800591, 1.274250676740249, 1.2725504747856013, 1.2708494098886597,
+	1.2691474701654725, 1.2674446436748051, 1.2657409184173421, 1.2640362823348814,
+	1.2623307233095177, 1.2606242291628173, 1.2589167876549827, 1.2572083864840076,
+	1.2554990132848211, 1.2537886556284226, 1.2520773010210058, 1.2503649369030713,
+	1.2486515506485299, 1.2469371295637934, 1.2452216608868551, 1.2435051317863584,
+	1.2417875293606542, 1.2400688406368456, 1.2383490525698218, 1.2366281520412787,
+	1.2349061258587272, 1.2331829607544892, 1.2314586433846805, 1.2297331603281801,
+	1.2280064980855864, 1.2262786430781599, 1.2245495816467518, 1.2228193000507184,
+	1.221087784466821, 1.2193550209881114, 1.2176209956228021, 1.2158856942931217,
+	1.2141491028341543, 1.2124112069926633, 1.2106719924258995, 1.2089314447003918,
+	1.2071895492907226, 1.2054462915782851, 1.2037016568500233, 1.2019556302971554,
+	1.2002081970138781, 1.1984593419960529, 1.1967090501398742, 1.1949573062405178,
+	1.1932040949907704, 1.1914494009796392, 1.1896932086909415, 1.1879355025018735,
+	1.1861762666815588, 1.1844154853895752, 1.1826531426744597, 1.1808892224721917,
+	1.1791237086046535, 1.1773565847780681, 1.1755878345814129, 1.1738174414848103,
+	1.1720453888378937, 1.1702716598681482, 1.1684962376792268, 1.1667191052492402,
+	1.1649402454290207, 1.1631596409403586, 1.1613772743742122, 1.1595931281888892,
+	1.1578071847081995, 1.1560194261195796, 1.1542298344721871, 1.1524383916749645,
+	1.1506450794946728, 1.1488498795538936, 1.1470527733289984, 1.1452537421480862,
+	1.1434527671888868, 1.1416498294766303, 1.1398449098818819, 1.1380379891183407,
+	1.1362290477406033, 1.1344180661418887, 1.1326050245517271, 1.1307899030336085,
+	1.1289726814825936, 1.1271533396228829, 1.1253318570053456, 1.1235082130050059,
+	1.1216823868184876, 1.1198543574614134, 1.1180241037657602, 1.1161916043771692,
+	1.1143568377522085, 1.1125197821555882, 1.1106804156573272, 1.1088387161298696,
+	1.1069946612451507, 1.1051482284716107, 1.1032993950711553, 1.1014481380960619,
+	1.0995944343858308, 1.0977382605639783, 1.0958795930347733, 1.0940184079799135,
+	1.0921546813551409, 1.0902883888867961, 1.0884195060683078, 1.0865480081566182,
+	1.0846738701685418, 1.0827970668770562, 1.080917572807523, 1.0790353622338379,
+	1.0771504091745079, 1.0752626873886538, 1.0733721703719366, 1.0714788313524055,
+	1.0695826432862663, 1.0676835788535679, 1.0657816104538044, 1.0638767102014322,
+	1.0619688499212991, 1.0600580011439824, 1.0581441351010363, 1.0562272227201436,
+	1.0543072346201712, 1.0523841411061266, 1.0504579121640123, 1.0485285174555765,
+	1.0465959263129568, 1.0446601077332147, 1.0427210303727581, 1.0407786625416484,
+	1.0388329721977901, 1.0368839269409994, 1.0349314940069488, 1.0329756402609846,
+	1.0310163321918138, 1.0290535359050573, 1.027087217116666, 1.0251173411461956,
+	1.0231438729099371, 1.0211667769138986, 1.019186017246635, 1.0172015575719213,
+	1.015213361121265, 1.0132213906862539, 1.0112256086107343, 1.0092259767828153,
+	1.0072224566266943, 1.0052150090942992, 1.0032035946567416, 1.0011881732955758,
+	0.99916870449385943, 0.99714514722700826, 0.99511745995344095, 0.99308560060500705,
+	0.99104952657719234, 0.98900919471909512, 0.98696456132316683, 0.9849155821147104,
+	0.98286221224112907, 0.98080440626091863, 0.97874211813239548, 0.97667530120215272,
+	0.97460390819323638, 0.97252789119303331, 0.97044720164086225, 0.9683617903152591,
+	0.96627160732094721, 0.96417660207548314, 0.96207672329556799, 0.95997191898301404,
+	0.95786213641035609, 0.95574732210609651, 0.95362742183957254, 0.95150238060543416,
+	0.94937214260771997, 0.94723665124351876, 0.94509584908620314, 0.94294967786822193,
+	0.94079807846343679, 0.93864099086898851, 0.93647835418667758, 0.93431010660384316,
+	0.93213618537372383, 0.92995652679528312, 0.92777106619248179, 0.92557973789297849,
+	0.92338247520623932, 0.92117921040103645, 0.91896987468231478, 0.91675439816740506,
+	0.91453270986156075, 0.91230473763279529, 0.91007040818599518, 0.90782964703628345,
+	0.90558237848160695, 0.90332852557451983, 0.90106801009313436, 0.89880075251120911,
+	0.89652667196734308, 0.89424568623324314, 0.89195771168103079, 0.88966266324955249,
+	0.88736045440965658, 0.885050997128398, 0.88273420183213022, 0.88040997736844231,
+	0.87807823096689666, 0.87573886819852139, 0.87339179293400902, 0.87103690730057094,
+	0.86867411163739469, 0.86630330444964896, 0.8639243823609781, 0.86153724006442574,
+	0.85914177027172376, 0.85673786366088028, 0.85432540882199656, 0.85190429220123992,
+	0.84947439804289574, 0.84703560832941791, 0.84458780271939347, 0.84213085848333222,
+	0.83966465043718843, 0.83718905087351636, 0.83470392949015666, 0.83220915331634528,
+	0.82970458663613095, 0.82719009090898114, 0.82466552468745037, 0.82213074353177767,
+	0.81958559992127318, 0.81702994316234595, 0.81446361929301736, 0.81188647098375551,
+	0.80929833743445732, 0.8066990542673949, 0.80408845341593285, 0.80146636300881179,
+	0.79883260724978186, 0.79618700629235749, 0.79352937610945108, 0.79085952835762935,
+	0.78817727023572056, 0.78548240433748477, 0.78277472849804167, 0.78005403563373208,
+	0.77732011357506897, 0.77457274489241293, 0.77181170671398353, 0.7690367705357938,
+	0.76624770202306861, 0.76344426080267902, 0.76062620024609481, 0.75779326724232379,
+	0.75494520196027195, 0.7520817375999198, 0.74920260013166985, 0.74630750802317528,
+	0.74339617195291269, 0.74046829450970981, 0.73752356987738333, 0.7345616835035817,
+	0.7315823117518622, 0.72858512153596075, 0.72556976993513591, 0.7225359037893851,
+	0.71948315927324009, 0.71641116144675012, 0.71331952378215356, 0.71020784766462152,
+	0.70707572186532917, 0.70392272198497075, 0.70074840986568163, 0.69755233296916359,
+	0.69433402371862657, 0.69109299880195936, 0.68782875843332135, 0.68454078557010506,
+	0.68122854508195285, 0.67789148286821719, 0.67452902491993008, 0.67114057632198904,
+	0.6677255201908714, 0.66428321654275011, 0.66081300108639793, 0.65731418393472704,
+	0.65378604822821022, 0.6502278486627609, 0.64663880991390281, 0.64301812494822612,
+	0.63936495321219346, 0.63567841868731279, 0.63195760779951903, 0.62820156716928434,
+	0.6244093011874869, 0.62057976940038552, 0.61671188368514381, 0.61280450519518948,
+	0.60885644105224248, 0.60486644075905423, 0.60083319230371514, 0.59675531792274438,
+	0.59263136948599975, 0.58845982346164538, 0.58423907541388457, 0.57996743397977548,
+	0.5756431142640447, 0.57126423058221365, 0.56682878847232971, 0.56233467588387854,
+	0.55777965343871358, 0.55316134364267064, 0.5484772189074422, 0.54372458821965621,
+	0.5389005822671785, 0.53400213680049191, 0.52902597396841677, 0.52396858132093804,
+	0.51882618811561256, 0.5135947384955481, 0.50826986102320693, 0.50284683395133291,
+	0.49732054548499951, 0.49168544813041245, 0.48593550602783111, 0.48006413391605098,
+	0.47406412605857651, 0.46792757305563486, 0.46164576394248423, 0.45520907029298402,
+	0.44860680815220977, 0.44182707243409204, 0.43485653682676967, 0.42768021008593056,
+	0.42028113662401233, 0.41264002516045349, 0.40473478333663186, 0.3965399277671025,
+	0.38802582664591284, 0.37915771356120063, 0.36989438294124715, 0.36018643329784926,
+	0.34997385305140908, 0.33918262481454335, 0.32771981845013761, 0.31546627221622941,
+	0.30226525688863183, 0.28790409666300536, 0.27208263356288829, 0.25435506476957548,
+	0.23401190899183447, 0.20980625468004372, 0.17917593134842254, 0.13506355863516847,
+	0.0,
+}};
+#else
+# error random-ziggurat.h: no table for DIST_NORMAL_ZIG_COUNT
+#endif
+
+#define DIST_NORMAL_ZIG__EQ(a, b) \
+	((a) - (b) <= (b) * 1e-6 && (b) - (a) <= (b) * 1e-6)
+#define DIST_NORMALF_ZIG_TABLE_OK \
+	(DIST_NORMAL_ZIG__EQ(DIST_NORMALF_ZIG_R, DIST_NORMALF_ZIG_TABLE_R) && \
+	 DIST_NORMAL_ZIG__EQ(DIST_NORMALF_ZIG_AREA, DIST_NORMALF_ZIG_TABLE_AREA))
+#define DIST_NORMAL_ZIG_TABLE_OK \
+	(DIST_NORMAL_ZIG__EQ(DIST_NORMAL_ZIG_R, DIST_NORMAL_ZIG_TABLE_R) && \
+	 DIST_NORMAL_ZIG__EQ(DIST_NORMAL_ZIG_AREA, DIST_NORMAL_ZIG_TABLE_AREA))
+
+#if defined(__cplusplus) && __cplusplus >= 201103L
+static_assert(DIST_NORMALF_ZIG_TABLE_OK, "random-ziggurat.h: "
+	"DIST_NORMALF_ZIG_R/AREA don't match the table");
+static_assert(DIST_NORMAL_ZIG_TABLE_OK, "random-ziggurat.h: "
+	"DIST_NORMAL_ZIG_R/AREA don't match the table");
+#elif defined(__GNUC__) && defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+/* floating point comparisons are an extension in _Static_assert */
+__extension__ _Static_assert(DIST_NORMALF_ZIG_TABLE_OK, "random-ziggurat.h: "
+	"DIST_NORMALF_ZIG_R/AREA don't match the table");
+__extension__ _Static_assert(DIST_NORMAL_ZIG_TABLE_OK, "random-ziggurat.h: "
+	"DIST_NORMAL_ZIG_R/AREA don't match the table");
+#endif
+
+static inline float
+dist_normalf_zig_static(uint32_t (*rand32)(void*), void *rng)
+{
+	assert(DIST_NORMALF_ZIG_TABLE_OK);
+	return dist_normalf_zig(&distNormalfZigStatic, rand32, rng);
+}
+
+static inline double
+dist_normal_zig_static(uint64_t (*rand64)(void*), void *rng)
+{
+	assert(DIST_NORMAL_ZIG_TABLE_OK);
+	return dist_normal_zig(&distNormalZigStatic, rand64, rng);
+}
+
+#define RANDOM_ZIGGURAT_H_INCLUDED
+#endif
@@ -0,0 +1,337 @@
+/* ring-buffer.h -- generic bounded lock-free queues
+ * Olaf Bernstein <camel-cdr@protonmail.com>
+ * Distributed under the MIT license, see license at the end of the file.
+ * New versions available at https://github.com/camel-cdr/cauldron
+ *
+ * Two bounded ring buffers, whose capacity is rounded up to a power of two:
+ *
+ * RbSpsc(T): single producer single consumer queue. The producer and the
+ *            consumer only share the head and tail index, which are on
+ *            separate cache lines. Both sides keep a cached copy of the
+ *            other index, so the shared cache line is only touched when the
+ *            queue looks full or empty.
+ *
+ * RbMpmc(T): multi producer multi consumer queue by Dmitry Vyukov <1>. Every
+ *            slot has a sequence number, that tells producers and consumers
+ *            in which round the slot is ready for them, so a successful CAS
+ *            on the head or tail index is enough to claim a slot.
+ *
+ * All operations are non-blocking: push and pop return 1 on success and 0 if
+ * the queue was full or empty, the bulk variants push_n and pop_n transfer as
+ * many of the n elements as possible and return how many they transferred.
+ * Elements are copied with memcpy.
+ *
+ * Note that any arguments passed to a rb_* function macros is potentially
+ * evaluated multiple times except for arguments that have the name p in the
+ * code bellow.
+ *
+ * References:
+ *
+ * <1> Dmitry Vyukov, "Bounded MPMC queue" (2011)
+ *     https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+ */
+
+#ifndef RING_BUFFER_H_INCLUDED
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(__GNUC__) && !defined(__clang__)
+# error "ring-buffer.h requires the GNU C __atomic builtins"
+#endif
+
+#ifndef RB_CACHE_LINE
+#define RB_CACHE_LINE 64
+#endif
+
+/* by default: exit on allocation failure, like stretchy-buffer.h */
+
+#ifndef rb_malloc
+static inline void *
+rb__malloc(size_t num_bytes)
+{
+	void *ptr;
+	if (!(ptr = malloc(num_bytes)))
+		perror("malloc failed"), exit(EXIT_FAILURE);
+	return ptr;
+}
+#define rb_malloc(s) rb__malloc(s)
+#endif
+#ifndef rb_dealloc
+#define rb_dealloc(p) free(p)
+#endif
+
+#define rb__LOAD(p,o) __atomic_load_n((p), __ATOMIC_##o)
+#define rb__STORE(p,v,o) __atomic_store_n((p), (v), __ATOMIC_##o)
+
+static inline size_t
+rb__pow2(size_t cap)
+{
+	size_t n = 2;
+	while (n < cap)
+		n *= 2;
+	return n;
+}
+
+/* copies n elements from src to ring[pos..], wrapping around at mask+1 */
+static inline void
+rb__copy_in(unsigned char *ring, size_t mask, size_t pos,
+            void const *src, size_t n, size_t size)
+{
+	size_t i = pos & mask, m = mask + 1 - i < n ? mask + 1 - i : n;
+	memcpy(ring + i * size, src, m * size);
+	memcpy(ring, (unsigned char const *)src + m * size, (n - m) * size);
+}
+
+static inline void
+rb__copy_out(unsigned char const *ring, size_t mask, size_t pos,
+             void *dst, size_t n, size_t size)
+{
+	size_t i = pos & mask, m = mask + 1 - i < n ? mask + 1 - i : n;
+	memcpy(dst, ring + i * size, m * size);
+	memcpy((unsigned char *)dst + m * size, ring, (n - m) * size);
+}
+
+
+/*
+ * Single producer single consumer
+ */
+
+typedef struct {
+	unsigned char *buf;
+	size_t mask, size;
+	char _pad0[RB_CACHE_LINE];
+	/* owned by the producer */
+	size_t head, tail_cache;
+	char _pad1[RB_CACHE_LINE];
+	/* owned by the consumer */
+	size_t tail, head_cache;
+	char _pad2[RB_CACHE_LINE];
+} RbSpscCore;
+
+static inline void
+rb__spsc_init(RbSpscCore *c, size_t cap, size_t size)
+{
+	memset(c, 0, sizeof *c);
+	c->mask = rb__pow2(cap) - 1;
+	c->size = size;
+	c->buf = (unsigned char *)rb_malloc((c->mask + 1) * size);
+}
+
+static inline size_t
+rb__spsc_push(RbSpscCore *c, void const *src, size_t n)
+{
+	size_t head = c->head, space = c->mask + 1 - (head - c->tail_cache);
+	if (space < n) {
+		c->tail_cache = rb__LOAD(&c->tail, ACQUIRE);
+		space = c->mask + 1 - (head - c->tail_cache);
+		if (n > space)
+			n = space;
+	}
+	rb__copy_in(c->buf, c->mask, head, src, n, c->size);
+	rb__STORE(&c->head, head + n, RELEASE);
+	return n;
+}
+
+static inline size_t
+rb__spsc_pop(RbSpscCore *c, void *dst, size_t n)
+{
+	size_t tail = c->tail, avail = c->head_cache - tail;
+	if (avail < n) {
+		c->head_cache = rb__LOAD(&c->head, ACQUIRE);
+		avail = c->head_cache - tail;
+		if (n > avail)
+			n = avail;
+	}
+	rb__copy_out(c->buf, c->mask, tail, dst, n, c->size);
+	rb__STORE(&c->tail, tail + n, RELEASE);
+	return n;
+}
+
+
+/*
+ * Multi producer multi consumer
+ */
+
+typedef struct {
+	size_t *seq;
+	unsigned char *buf;
+	size_t mask, size;
+	char _pad0[RB_CACHE_LINE];
+	size_t head;
+	char _pad1[RB_CACHE_LINE];
+	size_t tail;
+	char _pad2[RB_CACHE_LINE];
+} RbMpmcCore;
+
+static inline void
+rb__mpmc_init(RbMpmcCore *c, size_t cap, size_t size)
+{
+	size_t i;
+	memset(c, 0, sizeof *c);
+	c->mask = rb__pow2(cap) - 1;
+	c->size = size;
+	/* one allocation, buf is aligned, since the capacity is even */
+	c->seq = (size_t *)rb_malloc((c->mask + 1) * (sizeof *c->seq + size));
+	c->buf = (unsigned char *)(c->seq + c->mask + 1);
+	for (i = 0; i <= c->mask; ++i)
+		c->seq[i] = i;
+}
+
+/*
+ * A slot at position pos is free for producers if its sequence number is pos
+ * and full for consumers if its sequence number is pos+1. The bulk variants
+ * count the consecutive ready slots and claim them all with one CAS. This is
+ * safe, since a ready slot stays ready until its position is claimed.
+ */
+
+static inline size_t
+rb__mpmc_push(RbMpmcCore *c, void const *src, size_t n)
+{
+	size_t pos = rb__LOAD(&c->head, RELAXED), i;
+	if (n == 0)
+		return 0;
+	for (;;) {
+		size_t seq = 0;
+		for (i = 0; i < n; ++i) {
+			seq = rb__LOAD(&c->seq[(pos + i) & c->mask], ACQUIRE);
+			if (seq != pos + i)
+				break;
+		}
+		if (i > 0) {
+			if (__atomic_compare_exchange_n(&c->head, &pos, pos + i, 1,
+			                      __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				break;
+		} else if ((ptrdiff_t)(seq - pos) < 0) {
+			return 0; /* full */
+		} else {
+			pos = rb__LOAD(&c->head, RELAXED);
+		}
+	}
+	for (n = i, i = 0; i < n; ++i) {
+		memcpy(c->buf + ((pos + i) & c->mask) * c->size,
+		       (unsigned char const *)src + i * c->size, c->size);
+		rb__STORE(&c->seq[(pos + i) & c->mask], pos + i + 1, RELEASE);
+	}
+	return n;
+}
+
+static inline size_t
+rb__mpmc_pop(RbMpmcCore *c, void *dst, size_t n)
+{
+	size_t pos = rb__LOAD(&c->tail, RELAXED), i;
+	if (n == 0)
+		return 0;
+	for (;;) {
+		size_t seq = 0;
+		for (i = 0; i < n; ++i) {
+			seq = rb__LOAD(&c->seq[(pos + i) & c->mask], ACQUIRE);
+			if (seq != pos + i + 1)
+				break;
+		}
+		if (i > 0) {
+			if (__atomic_compare_exchange_n(&c->tail, &pos, pos + i, 1,
+			                      __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				break;
+		} else if ((ptrdiff_t)(seq - (pos + 1)) < 0) {
+			return 0; /* empty */
+		} else {
+			pos = rb__LOAD(&c->tail, RELAXED);
+		}
+	}
+	for (n = i, i = 0; i < n; ++i) {
+		memcpy((unsigned char *)dst + i * c->size,
+		       c->buf + ((pos + i) & c->mask) * c->size, c->size);
+		rb__STORE(&c->seq[(pos + i) & c->mask],
+		          pos + i + c->mask + 1, RELEASE);
+	}
+	return n;
+}
+
+
+/* The typed pointer _t is never accessed, it only carries the element type. */
+#define RbSpsc(T) struct { RbSpscCore _c; T *_t; }
+#define RbMpmc(T) struct { RbMpmcCore _c; T *_t; }
+
+/* the conditional operator makes sure p points to the element type */
+#define rb__SRC(q,p) (1 ? (p) : (q)->_t)
+
+#define rb_spsc_init(q,cap) rb__spsc_init(&(q)->_c, (cap), sizeof *(q)->_t)
+#define rb_spsc_free(q) (rb_dealloc((q)->_c.buf), (q)->_c.buf = 0)
+#define rb_spsc_push(q,p) rb__spsc_push(&(q)->_c, rb__SRC(q, p), 1)
+#define rb_spsc_pop(q,p) rb__spsc_pop(&(q)->_c, rb__SRC(q, p), 1)
+#define rb_spsc_push_n(q,p,n) rb__spsc_push(&(q)->_c, rb__SRC(q, p), (n))
+#define rb_spsc_pop_n(q,p,n) rb__spsc_pop(&(q)->_c, rb__SRC(q, p), (n))
+
+#define rb_mpmc_init(q,cap) rb__mpmc_init(&(q)->_c, (cap), sizeof *(q)->_t)
+#define rb_mpmc_free(q) (rb_dealloc((q)->_c.seq), (q)->_c.seq = 0)
+#define rb_mpmc_push(q,p) rb__mpmc_push(&(q)->_c, rb__SRC(q, p), 1)
+#define rb_mpmc_pop(q,p) rb__mpmc_pop(&(q)->_c, rb__SRC(q, p), 1)
+#define rb_mpmc_push_n(q,p,n) rb__mpmc_push(&(q)->_c, rb__SRC(q, p), (n))
+#define rb_mpmc_pop_n(q,p,n) rb__mpmc_pop(&(q)->_c, rb__SRC(q, p), (n))
+
+#define rb_cap(q) ((q)._c.mask + 1)
+
+#define RING_BUFFER_H_INCLUDED
+#endif
+
+/*
+ * Example:
+ */
+
+#ifdef RING_BUFFER_EXAMPLE
+
+#include <stdio.h>
+#include <pthread.h>
+
+static RbSpsc(int) q;
+
+static void *
+producer(void *arg)
+{
+	int i;
+	for (i = 0; i < 100; ++i)
+		while (!rb_spsc_push(&q, &i));
+	return arg;
+}
+
+int
+main(void)
+{
+	pthread_t t;
+	int i, x;
+
+	rb_spsc_init(&q, 16);
+	pthread_create(&t, 0, producer, 0);
+	for (i = 0; i < 100; ++i) {
+		while (!rb_spsc_pop(&q, &x));
+		printf("%d\n", x);
+	}
+	pthread_join(t, 0);
+	rb_spsc_free(&q);
+	return 0;
+}
+
+#endif /* RING_BUFFER_EXAMPLE */
+
+
+/*
+ * Copyright (c) 2022 Olaf Berstein
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
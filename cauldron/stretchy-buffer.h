@@ -15,10 +15,15 @@
 
 /* by default: exit on allocation failure */
 
-#if !(defined sb_malloc) || !(defined sb_realloc)
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+
+#if !(defined sb_malloc) && !(defined sb_realloc)
+# define sb__DEFAULT_ALLOC 1
+#endif
 
+#if !(defined sb_malloc) || !(defined sb_realloc)
 static inline void *
 sb__realloc(void *ptr, size_t num_bytes)
 {
@@ -36,9 +41,191 @@ sb__realloc(void *ptr, size_t num_bytes)
 #endif
 
 
+/* sb_grow(old,min) computes the new capacity in bytes, when a buffer of old
+ * bytes needs to hold at least min bytes. It can be redefined, but defaults
+ * to sb_grow_classes, which grows to the next size of the form 2^k or 1.5*2^k,
+ * so alternatingly by 1.5x and 1.33x, as that fits the size classes of most
+ * malloc implementations. Buffers of at least sb_MMAP_MIN bytes grow by 1.5x
+ * rounded up to a multiple of sb_PAGE_SIZE instead.
+ * sb_grow_2x always doubles and rounds up to a power of two.
+ *
+ * If sb_MMAP is defined and the default allocator is used on Linux, buffers of
+ * at least sb_MMAP_MIN bytes are directly allocated with mmap and grown with
+ * mremap, which can remap the pages instead of copying them. Such buffers must
+ * be released with sb_free instead of free. Since mremap is a GNU extension,
+ * this also requires _GNU_SOURCE to be defined before including any system
+ * header. */
+#ifndef sb_PAGE_SIZE
+#define sb_PAGE_SIZE 4096
+#endif
+#ifndef sb_MMAP_MIN
+#define sb_MMAP_MIN (1024*1024)
+#endif
+#ifndef sb_grow
+#define sb_grow(old,min) sb_grow_classes(old, min)
+#endif
+
+static inline size_t
+sb_grow_classes(size_t old, size_t min)
+{
+	size_t n = old + 1, c;
+	if (old >= sb_MMAP_MIN)
+		n = old + (old >> 1);
+	if (n < min)
+		n = min;
+	if (n >= sb_MMAP_MIN)
+		return (n + sb_PAGE_SIZE - 1) & ~(size_t)(sb_PAGE_SIZE - 1);
+	for (c = 16; c < n; c *= 2)
+		if (c + (c >> 1) >= n)
+			return c + (c >> 1);
+	return c;
+}
+
+static inline size_t
+sb_grow_2x(size_t old, size_t min)
+{
+	size_t c = 16;
+	old *= 2;
+	while (c < old || c < min)
+		c *= 2;
+	return c;
+}
+
+#if defined(sb_MMAP) && defined(__linux__) && sb__DEFAULT_ALLOC
+# include <sys/mman.h>
+# ifdef MREMAP_MAYMOVE
+#  define sb__MREMAP 1
+# endif
+#endif
+
+#ifdef sb__MREMAP
+static inline void *
+sb__mremap(void *ptr, size_t old, size_t size)
+{
+	void *p;
+	if (old >= sb_MMAP_MIN && size >= sb_MMAP_MIN) {
+		p = mremap(ptr, old, size, MREMAP_MAYMOVE);
+	} else if (size >= sb_MMAP_MIN) {
+		p = mmap(0, size, PROT_READ | PROT_WRITE,
+		         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (p != MAP_FAILED && ptr)
+			memcpy(p, ptr, old), free(ptr);
+	} else {
+		p = sb__realloc(0, size);
+		memcpy(p, ptr, size);
+		munmap(ptr, old);
+	}
+	if (p == MAP_FAILED)
+		perror("mremap failed"), exit(EXIT_FAILURE);
+	return p;
+}
+#endif
+
+
+/* A buffer can use a custom allocator instead of sb_malloc/sb_realloc/free,
+ * by pointing it to an SbAllocator with sb_setalloc while it's still empty.
+ * realloc receives the old size in bytes and is called with size=0 to free.
+ * sb_initcap and sb_initlen reset the buffer to the default allocator.
+ * If arena-allocator.h was included before, sb_aa_allocator creates an
+ * allocator that grows the buffer inside an aa_Arena. */
+typedef struct {
+	void *(*realloc)(void *ctx, void *ptr, size_t old, size_t size);
+	void *ctx;
+} SbAllocator;
+
+static inline void *
+sb__alloc(SbAllocator const *al, void *ptr, size_t old, size_t size)
+{
+	if (!al) {
+#ifdef sb__MREMAP
+		if (old >= sb_MMAP_MIN || size >= sb_MMAP_MIN)
+			return sb__mremap(ptr, old, size);
+#endif
+		return ptr ? sb_realloc(ptr, size) : sb_malloc(size);
+	}
+	if (!al->realloc)
+		return ptr; /* SbSmall inline storage */
+	if (!(ptr = al->realloc(al->ctx, ptr, old, size)) && size)
+		perror("realloc failed"), exit(EXIT_FAILURE);
+	return ptr;
+}
+
+static inline void
+sb__dealloc(SbAllocator const *al, void *ptr, size_t old)
+{
+	if (!al) {
+#ifdef sb__MREMAP
+		if (old >= sb_MMAP_MIN) {
+			munmap(ptr, old);
+			return;
+		}
+#endif
+		free(ptr);
+	} else if (ptr && al->realloc) {
+		al->realloc(al->ctx, ptr, old, 0);
+	}
+}
+
+static inline void *
+sb__grow(SbAllocator const **al, void *ptr, size_t *cap, size_t n, size_t size)
+{
+	size_t old = *cap * size;
+	*cap = sb_grow(old, n * size) / size;
+	if (*al && !(*al)->realloc) {
+		/* spill the inline storage of an SbSmall to the heap */
+		void *p = sb__alloc(0, 0, 0, *cap * size);
+		if (old)
+			memcpy(p, ptr, old);
+		*al = 0;
+		return p;
+	}
+	return sb__alloc(*al, ptr, old, *cap * size);
+}
+
+#ifdef ARENA_ALLOCATOR_H_INCLUDED
+static inline void *
+sb__aa_realloc(void *ctx, void *ptr, size_t old, size_t size)
+{
+	return aa_realloc((aa_Arena *)ctx, ptr, old, size);
+}
+
+static inline SbAllocator
+sb_aa_allocator(aa_Arena *arena)
+{
+	SbAllocator al;
+	al.realloc = sb__aa_realloc;
+	al.ctx = arena;
+	return al;
+}
+#endif
+
 
 /* can be zero initialized */
-#define Sb(T) struct { T *at; size_t _len, _cap; }
+#define Sb(T) struct { T *at; size_t _len, _cap; SbAllocator const *_alloc; }
+
+#define sb_setalloc(a,al) (assert(!(a)->at), (a)->_alloc = (al))
+
+/* SbSmall stores up to N elements inline and only spills to the heap once it
+ * outgrows them, after which it behaves like a regular Sb. It's compatible
+ * with all sb_* functions, but needs to be initialized with sb_initsmall,
+ * which can also be used to reset it after sb_free. While the inline storage
+ * is used, at points into the struct itself, so it mustn't be copied. */
+#define SbSmall(T,N) \
+	struct { T *at; size_t _len, _cap; SbAllocator const *_alloc; T _small[N]; }
+
+/* marks buffers using their inline storage, the address of the static
+ * differs between translation units, so only the NULL realloc is checked */
+static inline SbAllocator const *
+sb__small(void)
+{
+	static SbAllocator const small = { 0, 0 };
+	return &small;
+}
+
+#define sb_initsmall(a) ((a)->at = (a)->_small, (a)->_len = 0, \
+                         (a)->_cap = sizeof (a)->_small / sizeof *(a)->_small, \
+                         (a)->_alloc = sb__small())
+#define sb_issmall(a) ((a).at == (a)._small)
 
 #define sb_len(a) (+(a)._len)
 #define sb_cap(a) (+(a)._cap)
@@ -47,10 +234,12 @@ sb__realloc(void *ptr, size_t num_bytes)
 #define sb_last(a) ((a).at + (a)._len - 1)
 #define sb_end(a) ((a).at + (a)._len)
 
-#define sb_initcap(a,n) ((a)->_len = 0, (a)->_cap = (n), \
-                         (a)->at = sb_malloc((a)->_cap * sizeof *(a)->at))
-#define sb_initlen(a,n) ((a)->_len = (a)->_cap = (n), \
-                         (a)->at = sb_malloc((a)->_cap * sizeof *(a)->at))
+#define sb_initcap(a,n) ((a)->_len = 0, (a)->_cap = (n), (a)->_alloc = 0, \
+                         (a)->at = sb__alloc(0, 0, 0, \
+                                             (a)->_cap * sizeof *(a)->at))
+#define sb_initlen(a,n) ((a)->_len = (a)->_cap = (n), (a)->_alloc = 0, \
+                         (a)->at = sb__alloc(0, 0, 0, \
+                                             (a)->_cap * sizeof *(a)->at))
 
 #define sb_cpy(dest, src) \
 		(sb_setlen((dest), (src)._len), \
@@ -68,16 +257,32 @@ sb__realloc(void *ptr, size_t num_bytes)
 
 #define sb_setlen(a,n) ((a)->_len = (n), sb_setcap((a), (a)->_len))
 #define sb_setcap(a,n) ((a)->_cap < (n) ? \
-		((a)->_cap = ((a)->_cap * 3 >> 1) | (n), \
-		 (a)->at = sb_realloc((a)->at, (a)->_cap * sizeof *(a)->at)) : 0)
+		((a)->at = sb__grow(&(a)->_alloc, (a)->at, &(a)->_cap, (n), \
+		                    sizeof *(a)->at)) : 0)
 #define sb_reserve(a,n) sb_setcap((a), (a)->_cap + (n))
 
 #define sb_push(a,v) (sb_setlen((a), (a)->_len + 1), (a)->at[(a)->_len - 1] = (v))
 #define sb_addn(a,n) sb_setlen((a), (a)->_len + (n))
 
-#define sb_free(a) (free((a)->at), (a)->at = 0, (a)->_len = (a)->_cap = 0)
-#define sb_shrink(a) ((((a)->_cap = (a)->_len) == 0) ? sb_free(a), 0 : \
-                      ((a)->at = realloc((a)->at, (a)->_cap * sizeof *(a)->at), 0))
+/* returns a pointer to the n new uninitialized elements at the end */
+#define sb_extend_uninit(a,n) (sb_addn((a), (n)), (a)->at + (a)->_len - (n))
+#define sb_emplace(a) sb_extend_uninit((a), 1)
+
+/* src mustn't point into the buffer itself */
+#define sb_append(a,src,n) \
+		(assert(sizeof *(a)->at == sizeof *(src)), \
+		 memcpy(sb_extend_uninit((a), (n)), (src), (n) * sizeof *(a)->at))
+
+#define sb_free(a) (sb__dealloc((a)->_alloc, (a)->at, \
+                                 (a)->_cap * sizeof *(a)->at), \
+                    (a)->at = 0, (a)->_len = (a)->_cap = 0)
+/* a no-op while an SbSmall uses its inline storage */
+#define sb_shrink(a) ((a)->_alloc && !(a)->_alloc->realloc ? 0 : \
+                      (a)->_len == 0 ? sb_free(a), 0 : \
+                      ((a)->at = sb__alloc((a)->_alloc, (a)->at, \
+                                           (a)->_cap * sizeof *(a)->at, \
+                                           (a)->_len * sizeof *(a)->at), \
+                       (a)->_cap = (a)->_len, 0))
 
 /* n <= sb_len && n > 0*/
 #define sb_popn(a,n) (assert((n) <= (a)->_len && (n) > 0), (a)->_len -= (n))
@@ -104,6 +309,11 @@ sb__realloc(void *ptr, size_t num_bytes)
                          memmove((a)->at + (i) + (n), (a)->at + (i), \
                          ((a)->_len - (n) - (i)) * sizeof *(a)->at)))
 #define sb_ins(a,i,v) (sb_insn((a), (i), 1), (a)->at[i] = (v))
+/* 0 <= i <= sb_len, src mustn't point into the buffer itself */
+#define sb_insert_range(a,i,src,n) \
+		(assert(sizeof *(a)->at == sizeof *(src)), \
+		 sb_insn((a), (i), (n)), \
+		 memcpy((a)->at + (i), (src), (n) * sizeof *(a)->at))
 
 #define STRETCHY_BUFFER_H_INCLUDED
 #endif
@@ -0,0 +1,74 @@
+#include <stdio.h>
+
+#define aa_STATS
+#define ARENA_ALLOCATOR_IMPLEMENT
+#include <cauldron/arena-allocator.h>
+#include <cauldron/test.h>
+
+int
+main(void)
+{
+	int i;
+	aa_Arena a = { 0 };
+	aa_Stats *s = &a.stats;
+	aa_Mark m;
+
+	TEST_BEGIN(("aa_Stats"));
+	TEST_ASSERT(aa_alloc_packed(&a, 1));
+	TEST_ASSERT(aa_alloc_aligned(&a, 8, 8));
+	TEST_ASSERT(s->requested == 9 && s->padding == 7);
+	TEST_ASSERT(s->blocks == 1 && s->large_blocks == 0);
+	TEST_ASSERT(s->reserved >= aa_BLOCK_SIZE);
+	TEST_ASSERT(s->hist[1] == 1 && s->hist[4] == 1);
+
+	m = aa_mark(&a);
+	for (i = 0; i < 1000; ++i)
+		TEST_ASSERT(aa_alloc(&a, 1000));
+	TEST_ASSERT(aa_alloc(&a, aa_BLOCK_MAX));
+	TEST_ASSERT(s->blocks > 1 && s->large_blocks == 1);
+	TEST_ASSERT(s->tail_waste > 0);
+	TEST_ASSERT(s->hist[10] == 1000);
+	TEST_ASSERT(s->allocs == 1003);
+	TEST_ASSERT(s->reserved > aa_BLOCK_MAX + 1000 * 1000);
+
+	aa_rewind(&a, m);
+	TEST_ASSERT(s->requested == 9 && s->padding == 7);
+	TEST_ASSERT(s->tail_waste == 0 && s->large_blocks == 0);
+	TEST_ASSERT(s->reserved < aa_BLOCK_MAX);
+	TEST_ASSERT(s->peak >= aa_BLOCK_MAX + 1000 * 1000);
+
+	/* resizing the last allocation replaces it in the counts, the padding
+	 * in front of it stays */
+	{
+		size_t allocs = s->allocs;
+		char *p = (char *)aa_alloc_packed(&a, 3), *q;
+		TEST_ASSERT(p == aa_realloc(&a, p, 3, 5));
+		TEST_ASSERT(s->requested == 14 && s->padding == 7);
+		TEST_ASSERT(s->allocs == allocs + 1);
+		TEST_ASSERT(s->hist[2] == 0 && s->hist[3] == 1);
+		q = (char *)aa_realloc(&a, p, 5, 16);
+		TEST_ASSERT(q >= p && q < p + 16);
+		TEST_ASSERT(s->requested == 25 && s->padding == 7 + (size_t)(q - p));
+		TEST_ASSERT(s->allocs == allocs + 1);
+		TEST_ASSERT(s->hist[3] == 0 && s->hist[5] == 1);
+		TEST_ASSERT(!aa_realloc(&a, q, 16, 0));
+		TEST_ASSERT(s->requested == 9 && s->allocs == allocs);
+	}
+
+	aa_dealloc(&a);
+	TEST_ASSERT(s->requested == 0 && s->deallocs == 1);
+	TEST_ASSERT(s->peak >= aa_BLOCK_MAX + 1000 * 1000);
+	{
+		FILE *f = tmpfile();
+		TEST_ASSERT(f);
+		aa_stats_print(&a, f);
+		TEST_ASSERT(ftell(f) > 0);
+		fclose(f);
+	}
+
+	aa_free(&a);
+	TEST_ASSERT(s->reserved == 0 && s->blocks == 0);
+	TEST_END();
+
+	return 0;
+}
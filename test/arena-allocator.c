@@ -1,9 +1,64 @@
+#define _DEFAULT_SOURCE
 #include <stdio.h>
+#include <string.h>
+#include <pthread.h>
 
 #define ARENA_ALLOCATOR_IMPLEMENT
 #include <cauldron/arena-allocator.h>
 #include <cauldron/test.h>
 
+#define THREADS 4
+#define THREAD_ALLOCS 100000
+
+static aa_ConcurrentArena shared;
+static size_t *thread_ptrs[THREADS][THREAD_ALLOCS];
+static size_t thread_ids[THREADS] = { 0, 1, 2, 3 };
+
+static void *
+thread_alloc(void *arg)
+{
+	size_t id = *(size_t *)arg, i;
+	aa_Arena a;
+	aa_init_concurrent(&a, &shared);
+	for (i = 0; i < THREAD_ALLOCS; ++i) {
+		size_t *p = aa_alloc(&a, (i % 4 + 1) * sizeof *p);
+		if (!p)
+			return arg;
+		*p = id * THREAD_ALLOCS + i;
+		thread_ptrs[id][i] = p;
+	}
+	/* oversized allocations directly come from the shared arena */
+	if (!aa_alloc(&a, 4 * 1024 * 1024))
+		return arg;
+	aa_free(&a);
+	return 0;
+}
+
+static aa_Pool pool;
+
+static void *
+thread_pool(void *arg)
+{
+	size_t id = *(size_t *)arg, i, j;
+	size_t *live[1000];
+	aa_PoolCache c;
+	aa_pool_cache_init(&c, &pool);
+	for (j = 0; j < 100; ++j) {
+		for (i = 0; i < 1000; ++i) {
+			if (!(live[i] = aa_pool_cache_alloc(&c)))
+				return arg;
+			live[i][0] = live[i][1] = id;
+		}
+		for (i = 0; i < 1000; ++i) {
+			if (live[i][0] != id || live[i][1] != id)
+				return arg;
+			aa_pool_cache_dealloc(&c, live[i]);
+		}
+	}
+	aa_pool_cache_flush(&c);
+	return 0;
+}
+
 int
 main(void)
 {
@@ -31,7 +86,209 @@ main(void)
 	}
 
 	TEST_END();
+
+	TEST_BEGIN(("aa_alloc_aligned"));
+	for (i = 0; i < 4096; ++i) {
+		size_t align = (size_t)1 << (i % 13);
+		size_t size = (size_t)(i * 7 % 100) + 1;
+		unsigned char *p = aa_alloc_aligned(&a, size, align);
+		TEST_ASSERT(p);
+		TEST_ASSERT_MSG(((size_t)p & (align - 1)) == 0, ("%p %u", (void*)p, (unsigned)align));
+		memset(p, 0xAA, size);
+	}
+	aa_dealloc(&a);
+	TEST_END();
+
+	TEST_BEGIN(("aa_alloc_packed"));
+	{
+		unsigned char *p = aa_alloc_packed(&a, 1);
+		TEST_ASSERT(aa_alloc_packed(&a, 3) == p + 1);
+		TEST_ASSERT(aa_alloc_packed(&a, 5) == p + 4);
+		/* aa_alloc only aligns to what a type of that size could need */
+		TEST_ASSERT(aa_alloc(&a, 1) == p + 9);
+		TEST_ASSERT(aa_alloc(&a, 2) == p + 10);
+		TEST_ASSERT(aa_alloc(&a, 4) == p + 12);
+		TEST_ASSERT(aa_alloc(&a, 6) == p + 16);
+		TEST_ASSERT(((size_t)aa_alloc(&a, 8) & 7) == 0);
+	}
+	aa_dealloc(&a);
+	TEST_END();
+
+	TEST_BEGIN(("aa_Arena block growth"));
+	{
+		struct aa_Block *b, *cur;
+		size_t n = 0, prev = 0;
+		for (i = 0; i < 1000000; ++i)
+			TEST_ASSERT(aa_alloc(&a, 40));
+		for (b = a.blocks; b; b = b->next, ++n) {
+			size_t size = (size_t)(b->end - b->first);
+			TEST_ASSERT(size >= prev);
+			prev = size;
+		}
+		/* 40MB in 16KB blocks */
+		TEST_ASSERT(n < 16);
+
+		cur = a.current;
+		TEST_ASSERT(aa_alloc(&a, aa_BLOCK_MAX));
+		TEST_ASSERT(a.current == cur && a.large);
+		TEST_ASSERT(aa_alloc(&a, 1) == cur->ptr - 1);
+
+		aa_dealloc(&a);
+		TEST_ASSERT(!a.large && a.current == a.blocks);
+		for (i = 0; i < 1000000; ++i)
+			TEST_ASSERT(aa_alloc(&a, 40));
+		for (b = a.blocks, i = 0; b; b = b->next)
+			++i;
+		TEST_ASSERT((size_t)i == n);
+	}
+	aa_dealloc(&a);
+	TEST_END();
+
+	TEST_BEGIN(("aa_mark/aa_rewind"));
 	aa_free(&a);
+	{
+		aa_Mark m0 = aa_mark(&a), m1, m2;
+		void *p0, *p1, *p2;
+		p0 = aa_alloc(&a, 100);
+		m1 = aa_mark(&a);
+		p1 = aa_alloc(&a, 100);
+		for (i = 0; i < 100000; ++i)
+			TEST_ASSERT(aa_alloc(&a, 64));
+		m2 = aa_mark(&a);
+		TEST_ASSERT(aa_alloc(&a, aa_BLOCK_MAX));
+		p2 = aa_alloc(&a, 100);
+		for (i = 0; i < 100000; ++i)
+			TEST_ASSERT(aa_alloc(&a, 64));
+		TEST_ASSERT(aa_alloc(&a, aa_BLOCK_MAX));
+
+		aa_rewind(&a, m2);
+		TEST_ASSERT(!a.large);
+		TEST_ASSERT(aa_alloc(&a, 100) == p2);
+		aa_rewind(&a, m1);
+		TEST_ASSERT(aa_alloc(&a, 100) == p1);
+		/* rewinding to an older mark discards the newer ones */
+		aa_rewind(&a, m0);
+		TEST_ASSERT(a.current == a.blocks);
+		TEST_ASSERT(aa_alloc(&a, 100) == p0);
+		aa_rewind(&a, m0);
+		aa_rewind(&a, m0);
+		TEST_ASSERT(aa_alloc(&a, 100) == p0);
+	}
+	TEST_END();
+
+	aa_free(&a);
+
+	TEST_BEGIN(("aa_init_vmem"));
+	TEST_ASSERT(aa_init_vmem(&a, (size_t)1 << 30, aa_HUGEPAGES));
+	{
+		unsigned char *p0 = aa_alloc_packed(&a, 1), *p = p0, *q;
+		aa_Mark m;
+		for (i = 0; i < 1000; ++i) {
+			/* allocations are contiguous */
+			TEST_ASSERT((q = aa_alloc_packed(&a, 100000)) == p + 1);
+			q[0] = q[99999] = 1;
+			p = q + 99999;
+		}
+		m = aa_mark(&a);
+		TEST_ASSERT(!aa_alloc(&a, (size_t)1 << 30));
+		TEST_ASSERT(aa_alloc_packed(&a, 1) == p + 1);
+		aa_rewind(&a, m);
+		TEST_ASSERT(aa_alloc_packed(&a, 1) == p + 1);
+
+		aa_dealloc(&a);
+		TEST_ASSERT(aa_alloc_packed(&a, 1) == p0);
+		TEST_ASSERT((q = aa_alloc_packed(&a, 100000000)) == p0 + 1);
+		/* the first aa_VMEM_COMMIT bytes are kept */
+		TEST_ASSERT(q[100000] == 1);
+		TEST_ASSERT(q[50 * 100000] == 0);
+		q[99999999] = 1;
+	}
+	aa_free(&a);
+	TEST_ASSERT(!a.blocks && !a.reserve_end);
+
+	/* an alignment beyond the end of the reservation fails */
+	TEST_ASSERT(aa_init_vmem(&a, aa_VMEM_COMMIT, 0));
+	TEST_ASSERT(!aa_alloc_aligned(&a, 1, (size_t)aa_VMEM_COMMIT * 4));
+	aa_free(&a);
+	/* a failed reservation leaves an empty arena */
+	TEST_ASSERT(!aa_init_vmem(&a, ~(size_t)0 / 2, 0));
+	TEST_ASSERT(!a.blocks && !a.reserve_end);
+	TEST_END();
+
+	TEST_BEGIN(("aa_ConcurrentArena"));
+	TEST_ASSERT(aa_concurrent_reserve(&shared, (size_t)1 << 30, 0, 0));
+	{
+		pthread_t threads[THREADS];
+		size_t j;
+		void *ret;
+		for (j = 0; j < THREADS; ++j)
+			pthread_create(threads + j, 0, thread_alloc, thread_ids + j);
+		for (j = 0; j < THREADS; ++j) {
+			pthread_join(threads[j], &ret);
+			TEST_ASSERT(!ret);
+		}
+		/* no allocation was overwritten by another thread */
+		for (j = 0; j < THREADS; ++j)
+			for (i = 0; i < THREAD_ALLOCS; ++i)
+				TEST_ASSERT(*thread_ptrs[j][i] == j * THREAD_ALLOCS + (size_t)i);
+
+		/* the reservation is exhausted eventually */
+		aa_init_concurrent(&a, &shared);
+		while (aa_alloc(&a, 1024))
+			;
+		TEST_ASSERT(shared.used >= shared.size);
+		aa_dealloc(&a);
+		TEST_ASSERT(aa_alloc(&a, 1024));
+		aa_free(&a);
+	}
+	aa_concurrent_free(&shared);
+	TEST_END();
+
+	TEST_BEGIN(("aa_Pool"));
+	{
+		unsigned char *p[100];
+		aa_pool_init(&pool, &a, 3, 1);
+		for (i = 0; i < 100; ++i)
+			TEST_ASSERT(p[i] = aa_pool_alloc(&pool));
+		/* at least as large as a pointer, but not aligned */
+		TEST_ASSERT(p[1] - p[0] == sizeof(void *));
+		for (i = 0; i < 100; i += 2)
+			aa_pool_dealloc(&pool, p[i]);
+		/* freed slots are reused in LIFO order */
+		for (i = 98; i >= 0; i -= 2)
+			TEST_ASSERT(aa_pool_alloc(&pool) == p[i]);
+		TEST_ASSERT(aa_pool_alloc(&pool) == p[99] + sizeof(void *));
+		aa_free(&a);
+
+		aa_pool_init(&pool, &a, 24, 0);
+		TEST_ASSERT(pool.size == 24 && pool.align == 8);
+		aa_pool_init(&pool, &a, 24, 64);
+		TEST_ASSERT(pool.size == 64);
+		for (i = 0; i < 100; ++i)
+			TEST_ASSERT(((size_t)aa_pool_alloc(&pool) & 63) == 0);
+		aa_free(&a);
+	}
+	TEST_END();
+
+	TEST_BEGIN(("aa_PoolCache"));
+	aa_pool_init(&pool, &a, 2 * sizeof(size_t), 0);
+	{
+		pthread_t threads[THREADS];
+		size_t j, n;
+		void *ret, *p;
+		for (j = 0; j < THREADS; ++j)
+			pthread_create(threads + j, 0, thread_pool, thread_ids + j);
+		for (j = 0; j < THREADS; ++j) {
+			pthread_join(threads[j], &ret);
+			TEST_ASSERT(!ret);
+		}
+		/* every slot was returned to the pool */
+		for (n = 0, p = pool.free; p; p = *(void **)p)
+			++n;
+		TEST_ASSERT(n >= 1000 && n <= THREADS * (1000 + 2 * aa_POOL_CACHE));
+	}
+	aa_free(&a);
+	TEST_END();
 
 	return 0;
 }
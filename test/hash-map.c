@@ -0,0 +1,107 @@
+#include <stdio.h>
+
+#include <cauldron/hash-map.h>
+#include <cauldron/test.h>
+
+#define RANGE 4096
+
+typedef struct { uint32_t x, y; } Point;
+
+int
+main(void)
+{
+	size_t i, n;
+	uint64_t s = 42;
+	static int ref[RANGE], has[RANGE];
+
+	TEST_BEGIN(("Hm put/get/del against a reference array"));
+	{
+		static Hm(uint32_t, int) m;
+
+		TEST_ASSERT(hm_len(m) == 0 && hm_cap(m) == 0);
+		TEST_ASSERT(!hm_get(&m, 1));
+		TEST_ASSERT(!hm_del(&m, 1));
+
+		for (i = 0; i < 200000; ++i) {
+			uint32_t k;
+			int *p;
+			s = hm__mix(s + i);
+			k = (uint32_t)(s >> 40) & (RANGE - 1);
+			if ((s & 3) == 3) {
+				TEST_ASSERT(hm_del(&m, k) == has[k]);
+				has[k] = 0;
+			} else if (s & 1) {
+				hm_put(&m, k, (int)i);
+				ref[k] = (int)i;
+				has[k] = 1;
+			} else {
+				p = hm_get(&m, k);
+				TEST_ASSERT_MSG(has[k] ? p && *p == ref[k] : !p,
+				                ("key %u", (unsigned)k));
+			}
+		}
+
+		for (n = i = 0; i < RANGE; ++i)
+			n += (size_t)has[i];
+		TEST_ASSERT(hm_len(m) == n);
+		for (n = i = 0; i < hm_cap(m); ++i) {
+			if (hm_occupied(m, i)) {
+				TEST_ASSERT(has[m.keys[i]]);
+				TEST_ASSERT(m.vals[i] == ref[m.keys[i]]);
+				++n;
+			}
+		}
+		TEST_ASSERT(n == hm_len(m));
+		/* tombstones mustn't make the table grow indefinitely */
+		TEST_ASSERT(hm_cap(m) <= RANGE * 2);
+
+		hm_clear(&m);
+		TEST_ASSERT(hm_len(m) == 0);
+		TEST_ASSERT(!hm_get(&m, m.keys[0]));
+		hm_free(&m);
+		TEST_ASSERT(hm_cap(m) == 0 && !m.keys && !m.vals);
+	}
+	TEST_END();
+
+	TEST_BEGIN(("Hm growth and reserve"));
+	{
+		static Hm(uint64_t, uint64_t) m;
+		size_t cap;
+
+		hm_reserve(&m, 1000);
+		cap = hm_cap(m);
+		TEST_ASSERT(cap >= 1000 && (cap & (cap - 1)) == 0);
+		for (i = 0; i < 1000; ++i)
+			hm_put(&m, i * 0x10000, i);
+		TEST_ASSERT(hm_cap(m) == cap);
+		for (i = 1000; i < 100000; ++i)
+			*hm_emplace(&m, i * 0x10000) = i;
+		TEST_ASSERT(hm_len(m) == 100000);
+		for (i = 0; i < 100000; ++i) {
+			uint64_t *p = hm_get(&m, i * 0x10000);
+			TEST_ASSERT(p && *p == i);
+			TEST_ASSERT(!hm_has(&m, i * 0x10000 + 1));
+		}
+		hm_free(&m);
+	}
+	TEST_END();
+
+	TEST_BEGIN(("Hm with struct keys"));
+	{
+		static Hm(Point, char) m;
+		Point p;
+		for (p.x = 0; p.x < 64; ++p.x)
+			for (p.y = 0; p.y < 64; ++p.y)
+				hm_put(&m, p, (char)(p.x ^ p.y));
+		TEST_ASSERT(hm_len(m) == 64 * 64);
+		p.x = 3, p.y = 5;
+		TEST_ASSERT(*hm_get(&m, p) == (3 ^ 5));
+		TEST_ASSERT(hm_del(&m, p) && !hm_has(&m, p));
+		p.x = 64;
+		TEST_ASSERT(!hm_has(&m, p));
+		hm_free(&m);
+	}
+	TEST_END();
+
+	return 0;
+}
@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <cauldron/stretchy-buffer.h>
+#define RS_THREADS 3
+#define RS_MT_MIN 4096
+#include <cauldron/radix-sort.h>
+#include <cauldron/test.h>
+
+#define MAX 100000
+
+static uint64_t
+hash64(uint64_t x)
+{
+	x ^= x >> 30;
+	x *= UINT64_C(0xBF58476D1CE4E5B9);
+	x ^= x >> 27;
+	x *= UINT64_C(0x94D049BB133111EB);
+	x ^= x >> 31;
+	return x;
+}
+
+static int
+cmp_u32(void const *lhs, void const *rhs)
+{
+	uint32_t l = *(uint32_t const *)lhs, r = *(uint32_t const *)rhs;
+	return l < r ? -1 : l > r;
+}
+
+static int
+cmp_u64(void const *lhs, void const *rhs)
+{
+	uint64_t l = *(uint64_t const *)lhs, r = *(uint64_t const *)rhs;
+	return l < r ? -1 : l > r;
+}
+
+static uint32_t a32[MAX], b32[MAX];
+static uint64_t a64[MAX], b64[MAX];
+static RsKv64 kv[MAX];
+
+int
+main(void)
+{
+	static size_t const sizes[] = { 0, 1, 2, 3, 255, 1000, 4095, 4096, MAX };
+	size_t i, j, n;
+
+	TEST_BEGIN(("rs_u32 and rs_u64 match qsort"));
+	for (j = 0; j < sizeof sizes / sizeof *sizes; ++j) {
+		n = sizes[j];
+		for (i = 0; i < n; ++i) {
+			a64[i] = b64[i] = hash64(i + j * MAX);
+			/* sometimes leave out whole digits, to test skipping */
+			a32[i] = b32[i] = (uint32_t)a64[i] & (j & 1 ? 0xFFFFu : ~0u);
+		}
+		rs_u32(a32, 0, n);
+		rs_u64(a64, 0, n);
+		qsort(b32, n, sizeof *b32, cmp_u32);
+		qsort(b64, n, sizeof *b64, cmp_u64);
+		TEST_ASSERT_MSG(!memcmp(a32, b32, n * sizeof *a32),
+		                ("n=%u", (unsigned)n));
+		TEST_ASSERT_MSG(!memcmp(a64, b64, n * sizeof *a64),
+		                ("n=%u", (unsigned)n));
+	}
+	TEST_END();
+
+	TEST_BEGIN(("rs_kv64 is stable"));
+	for (j = 0; j < sizeof sizes / sizeof *sizes; ++j) {
+		n = sizes[j];
+		for (i = 0; i < n; ++i) {
+			kv[i].key = hash64(i) & UINT64_C(0xF000000000000F0F);
+			kv[i].val = i;
+		}
+		rs_kv64(kv, (RsKv64 *)(void *)b64, n / 2);
+		rs_kv64(kv + n / 2, 0, n - n / 2);
+		rs_kv64(kv, 0, n);
+		for (i = 1; i < n; ++i) {
+			TEST_ASSERT(kv[i - 1].key <= kv[i].key);
+			if (kv[i - 1].key == kv[i].key)
+				TEST_ASSERT(kv[i - 1].val < kv[i].val);
+		}
+	}
+	TEST_END();
+
+	TEST_BEGIN(("sb_radix_sort"));
+	{
+		Sb(uint32_t) s = { 0 };
+		for (i = 0; i < MAX; ++i)
+			sb_push(&s, (uint32_t)(MAX - i));
+		sb_radix_sort(&s);
+		for (i = 0; i < MAX; ++i)
+			TEST_ASSERT(s.at[i] == i + 1);
+		sb_free(&s);
+	}
+	TEST_END();
+
+	return 0;
+}
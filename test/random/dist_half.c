@@ -0,0 +1,136 @@
+#define RANDOM_H_IMPLEMENTATION
+#include <cauldron/random.h>
+#include <cauldron/test.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+static PRNG64RomuQuad prng64;
+
+int
+main(void)
+{
+	uint32_t i;
+	uint16_t buf[1027];
+	static unsigned char seen[1u << 16];
+	double mb = 0, vb = 0, nb = 0, mh = 0, vh = 0, nh = 0;
+	prng64_romu_quad_randomize(&prng64);
+
+	TEST_BEGIN(("dist_f32_to_f16"));
+	for (i = 0; i < 0x10000u; ++i) {
+		uint16_t h = (uint16_t)i;
+		float f = dist_f16_to_f32(h);
+		if (((h >> 10) & 0x1F) == 0x1F && (h & 0x3FF))
+			continue; /* NaN */
+		TEST_ASSERT_MSG(dist_f32_to_f16(f) == h, ("%04x", i));
+	}
+	TEST_ASSERT(dist_f32_to_f16(1.0f) == 0x3C00);
+	TEST_ASSERT(dist_f32_to_f16(-2.0f) == 0xC000);
+	TEST_ASSERT(dist_f32_to_f16(65504.0f) == 0x7BFF);
+	TEST_ASSERT(dist_f32_to_f16(65520.0f) == 0x7C00);
+	TEST_ASSERT(dist_f32_to_f16(1.0f / 16777216) == 0x0001);
+	TEST_ASSERT(dist_f32_to_f16(1.0f / 33554432) == 0x0000);
+	TEST_ASSERT(dist_f32_to_f16(1.0f + 1.0f / 2048) == 0x3C00);
+	TEST_ASSERT(dist_f32_to_f16(1.0f + 3.0f / 2048) == 0x3C02);
+	TEST_END();
+
+	TEST_BEGIN(("dist_f32_to_bf16"));
+	for (i = 0; i < 0x10000u; ++i) {
+		uint16_t h = (uint16_t)i;
+		if (((h >> 7) & 0xFF) == 0xFF && (h & 0x7F))
+			continue; /* NaN */
+		TEST_ASSERT_MSG(dist_f32_to_bf16(dist_bf16_to_f32(h)) == h,
+		                ("%04x", i));
+	}
+	TEST_ASSERT(dist_f32_to_bf16(1.0f + 1.0f / 256) == 0x3F80);
+	TEST_ASSERT(dist_f32_to_bf16(1.0f + 3.0f / 256) == 0x3F82);
+	TEST_END();
+
+	TEST_BEGIN(("dist_uniform_f16 full range"));
+	for (i = 0; i < 0x10000u; ++i) {
+		uint16_t h = dist_uniform_f16((uint16_t)i);
+		float f = dist_f16_to_f32(h);
+		TEST_ASSERT(f >= 0 && f < 1);
+		TEST_ASSERT(f == (float)(i >> 5) / 2048);
+		seen[h] = 1;
+	}
+	for (i = 0; i < 2048; ++i)
+		TEST_ASSERT(seen[dist_f32_to_f16((float)i / 2048)]);
+	TEST_END();
+
+	TEST_BEGIN(("dist_uniform_bf16 full range"));
+	for (i = 0; i < 0x10000u; ++i) {
+		float f = dist_bf16_to_f32(dist_uniform_bf16((uint16_t)i));
+		TEST_ASSERT(f >= 0 && f < 1);
+		TEST_ASSERT(f == (float)(i >> 8) / 256);
+	}
+	TEST_END();
+
+	TEST_BEGIN(("dist_normal_f16_fast"));
+	{
+		double m = 0, v = 0;
+		for (i = 0; i < 0x10000u; ++i) {
+			float f = dist_f16_to_f32(
+					dist_normal_f16_fast((uint16_t)i));
+			float g = dist_bf16_to_f32(
+					dist_normal_bf16_fast((uint16_t)i));
+			TEST_ASSERT(fabsf(f) < 4.21f && fabsf(g) < 4.22f);
+			TEST_ASSERT(fabsf(f - dist_normalf_fast16((uint16_t)i))
+			            <= 1.0f / 1024);
+			m += f;
+			v += f * f;
+		}
+		m /= 0x10000;
+		v /= 0x10000;
+		TEST_ASSERT(fabs(m) < 1e-3);
+		TEST_ASSERT(fabs(v - 1) < 1e-3);
+	}
+	TEST_END();
+
+	/* the moments of the normal fills are accumulated over all iterations,
+	 * about 5000 samples, so the tolerances are at least 5 sigma */
+	TEST_BEGIN(("dist_*_f16_fill"));
+	for (i = 0; i < 5; ++i) {
+		size_t j, n = sizeof buf / sizeof *buf - i;
+		PRNG64RomuQuad a = prng64, b = prng64;
+		uint64_t u = 0;
+		float f;
+
+		buf[n - 1] = 0xFFFF;
+		dist_uniform_f16_fill(buf, n - 1, prng64_romu_quad, &a);
+		TEST_ASSERT(buf[n - 1] == 0xFFFF);
+		for (j = 0; j + 1 < n; ++j, u >>= 16) {
+			if (j % 4 == 0)
+				u = prng64_romu_quad(&b);
+			TEST_ASSERT(buf[j] == dist_uniform_f16((uint16_t)u));
+		}
+
+		dist_normal_bf16_fast_fill(buf, n, prng64_romu_quad, &prng64);
+		for (j = 0; j < n; ++j) {
+			f = dist_bf16_to_f32(buf[j]);
+			TEST_ASSERT(fabsf(f) < 4.22f);
+			mb += f, vb += f * f, nb += 1;
+		}
+
+		dist_uniform_bf16_fill(buf, n, prng64_romu_quad, &prng64);
+		for (j = 0; j < n; ++j) {
+			f = dist_bf16_to_f32(buf[j]);
+			TEST_ASSERT(f >= 0 && f < 1);
+		}
+
+		dist_normal_f16_fast_fill(buf, n, prng64_romu_quad, &prng64);
+		for (j = 0; j < n; ++j) {
+			f = dist_f16_to_f32(buf[j]);
+			TEST_ASSERT(fabsf(f) < 4.21f);
+			mh += f, vh += f * f, nh += 1;
+		}
+	}
+	mb /= nb, vb /= nb, mh /= nh, vh /= nh;
+	TEST_ASSERT_MSG(fabs(mb) < 0.08 && fabs(vb - 1) < 0.12,
+	                ("bf16 mean %g variance %g", mb, vb));
+	TEST_ASSERT_MSG(fabs(mh) < 0.08 && fabs(vh - 1) < 0.12,
+	                ("f16 mean %g variance %g", mh, vh));
+	TEST_END();
+
+	return 0;
+}
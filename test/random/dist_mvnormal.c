@@ -0,0 +1,83 @@
+#define RANDOM_H_IMPLEMENTATION
+#include <cauldron/random.h>
+#include <cauldron/test.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define DIM 5
+#define N (1024*256 + 13)
+
+static PRNG64RomuQuad prng64;
+static DistNormalZig zig;
+
+int
+main(void)
+{
+	static double const mean[DIM] = { 1, -2, 0, 0.5, 100 };
+	static double const cov[DIM*DIM] = {
+		4.0,  1.2, -0.8,  0.0, 0.3,
+		1.2,  2.0,  0.4,  0.1, 0.0,
+		-0.8, 0.4,  1.0, -0.2, 0.1,
+		0.0,  0.1, -0.2,  0.5, 0.0,
+		0.3,  0.0,  0.1,  0.0, 9.0,
+	};
+	static double const notpd[2*2] = { 1, 2, 2, 1 };
+	double *x, m[DIM] = { 0 }, c[DIM*DIM] = { 0 };
+	size_t i, j, k;
+	DistMvNormal mv;
+
+	prng64_romu_quad_randomize(&prng64);
+	dist_normal_zig_init(&zig);
+
+	TEST_BEGIN(("dist_mvnormal_init"));
+	TEST_ASSERT(dist_mvnormal_init(&mv, 0, notpd, 2) == 0);
+	TEST_ASSERT(dist_mvnormal_init(&mv, mean, cov, DIM) == 1);
+	TEST_ASSERT(((uintptr_t)mv.L & 63) == 0);
+	/* LL^T == cov */
+	for (i = 0; i < DIM; ++i) {
+		for (j = 0; j <= i; ++j) {
+			double s = 0;
+			for (k = 0; k <= j; ++k)
+				s += mv.L[i*(i+1)/2 + k] * mv.L[j*(j+1)/2 + k];
+			TEST_ASSERT(fabs(s - cov[i*DIM + j]) < 1e-12);
+		}
+	}
+	TEST_END();
+
+	TEST_BEGIN(("dist_mvnormal"));
+	x = (double*)malloc((N + 1) * DIM * sizeof *x);
+	TEST_ASSERT(x);
+	x[N*DIM] = 42;
+	dist_mvnormal(&mv, x, N, &zig, prng64_romu_quad, &prng64);
+	TEST_ASSERT(x[N*DIM] == 42);
+
+	for (k = 0; k < N; ++k)
+		for (i = 0; i < DIM; ++i)
+			m[i] += x[k*DIM + i];
+	for (i = 0; i < DIM; ++i)
+		m[i] /= N;
+	for (k = 0; k < N; ++k)
+		for (i = 0; i < DIM; ++i)
+			for (j = 0; j < DIM; ++j)
+				c[i*DIM + j] += (x[k*DIM + i] - m[i]) *
+				                (x[k*DIM + j] - m[j]);
+
+	/* the standard error of the mean is \sqrt{cov_ii/N} < 0.006 and of
+	 * the covariance about \sqrt{(cov_ij^2 + cov_ii cov_jj)/N} < 0.025 */
+	for (i = 0; i < DIM; ++i) {
+		TEST_ASSERT_MSG(fabs(m[i] - mean[i]) < 0.03,
+		                ("mean[%u] = %g", (unsigned)i, m[i]));
+		for (j = 0; j < DIM; ++j) {
+			c[i*DIM + j] /= N - 1;
+			TEST_ASSERT_MSG(fabs(c[i*DIM + j] - cov[i*DIM + j]) < 0.15,
+			                ("cov[%u][%u] = %g", (unsigned)i,
+			                 (unsigned)j, c[i*DIM + j]));
+		}
+	}
+	free(x);
+	dist_mvnormal_free(&mv);
+	TEST_END();
+
+	return 0;
+}
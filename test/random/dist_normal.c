@@ -26,9 +26,11 @@
 #define _USE_MATH_DEFINES
 #define RANDOM_H_IMPLEMENTATION
 #include <cauldron/random.h>
+#include <cauldron/random-ziggurat.h>
 #include <cauldron/test.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 static PRNG32RomuQuad prng32;
 static PRNG64RomuQuad prng64;
@@ -43,21 +45,45 @@ static double f_dist_normalf_zig(void)
 { return dist_normalf_zig(&zigf, prng32_romu_quad, &prng32); }
 static double f_dist_normal_zig(void)
 { return dist_normal_zig(&zig, prng64_romu_quad, &prng64); }
+static double f_dist_normalf_zig_static(void)
+{ return dist_normalf_zig_static(prng32_romu_quad, &prng32); }
+static double f_dist_normal_zig_static(void)
+{ return dist_normal_zig_static(prng64_romu_quad, &prng64); }
 static double f_dist_normalf_fast(void)
 { return dist_normalf_fast(prng64_romu_quad(&prng64)); }
+static double f_dist_normalf_popcnt1(void)
+{ return dist_normalf_popcnt(1, prng64_romu_quad, &prng64); }
+static double f_dist_normalf_popcnt4(void)
+{ return dist_normalf_popcnt(4, prng64_romu_quad, &prng64); }
+static double f_dist_normal_f16_fast(void)
+{ return dist_f16_to_f32(dist_normal_f16_fast(
+		(uint16_t)prng64_romu_quad(&prng64))); }
 
 static void
 test_norm(double (*norm)(void));
+static void
+test_ks(double (*norm)(void), double ks, size_t n);
 
 
 int
 main(void)
 {
+	size_t i;
+
 	prng32_romu_quad_randomize(&prng32);
 	prng64_romu_quad_randomize(&prng64);
 	dist_normalf_zig_init(&zigf);
 	dist_normal_zig_init(&zig);
 
+	TEST_BEGIN(("random-ziggurat.h tables"));
+	for (i = 0; i <= DIST_NORMALF_ZIG_COUNT; ++i)
+		TEST_ASSERT(fabs(zigf.x[i] - distNormalfZigStatic.x[i]) <=
+		            zigf.x[i] * 1e-5);
+	for (i = 0; i <= DIST_NORMAL_ZIG_COUNT; ++i)
+		TEST_ASSERT(fabs(zig.x[i] - distNormalZigStatic.x[i]) <=
+		            zig.x[i] * 1e-12);
+	TEST_END();
+
 #define TEST_NORM(norm) \
 	TEST_BEGIN((#norm)); test_norm(norm); TEST_END()
 
@@ -65,7 +91,41 @@ main(void)
 	TEST_NORM(f_dist_normal);
 	TEST_NORM(f_dist_normalf_zig);
 	TEST_NORM(f_dist_normal_zig);
+	TEST_NORM(f_dist_normalf_zig_static);
+	TEST_NORM(f_dist_normal_zig_static);
 	TEST_NORM(f_dist_normalf_fast);
+	TEST_NORM(f_dist_normal_f16_fast);
+	TEST_NORM(f_dist_normalf_popcnt1);
+	TEST_NORM(f_dist_normalf_popcnt4);
+
+	TEST_BEGIN(("dist_normalf_popcnt_fill"));
+	for (i = 1; i <= 8; ++i) {
+		float buf[300];
+		size_t j, n = sizeof buf / sizeof *buf - i;
+		PRNG64RomuQuad rng = prng64;
+		buf[n] = 42;
+		dist_normalf_popcnt_fill(buf, n, (unsigned)i,
+		                         prng64_romu_quad, &rng);
+		TEST_ASSERT(buf[n] == 42);
+		for (j = 0; j < n; ++j) {
+			float x = dist_normalf_popcnt((unsigned)i,
+			                              prng64_romu_quad, &prng64);
+			TEST_ASSERT(fabsf(buf[j] - x) <= 1e-6f);
+		}
+	}
+	TEST_END();
+
+	/* Kolmogorov-Smirnov distance, the second argument is the documented
+	 * distance of the approximation, the third the number of samples */
+#define TEST_KS(norm, ks, n) \
+	TEST_BEGIN((#norm " KS distance")); test_ks(norm, ks, n); TEST_END()
+
+	TEST_KS(f_dist_normal, 0, 1u << 20);
+	TEST_KS(f_dist_normal_zig, 0, 1u << 20);
+	TEST_KS(f_dist_normalf_fast, 0.0038, 1u << 22);
+	TEST_KS(f_dist_normal_f16_fast, 0.0053, 1u << 22);
+	TEST_KS(f_dist_normalf_popcnt1, 1.3e-3, 1u << 24);
+	TEST_KS(f_dist_normalf_popcnt4, 3.4e-4, 1u << 26);
 
 	return 0;
 }
@@ -189,6 +249,39 @@ test_norm5(void)
 	return (x1 - x2 <= -1);
 }
 
+/* The KS distance is computed from a histogram with bins of width 2^-14, so
+ * that large sample sizes fit into memory. The bins hold at most a probability
+ * mass of 2.5e-5, by which the result may underestimate the distance.
+ * The sampling error of the KS distance is below 2.5/\sqrt{n} with a
+ * probability of 1-2e^{-12.5}, roughly 1 in 130000, so n needs to be large
+ * enough for this to be small compared to the expected distance. */
+#define TEST_KS_BITS 14
+#define TEST_KS_BINS (16u << TEST_KS_BITS)
+
+static void
+test_ks(double (*norm)(void), double ks, size_t n)
+{
+	static uint32_t hist[TEST_KS_BINS];
+	size_t i, c = 0;
+	double d = 0;
+
+	memset(hist, 0, sizeof hist);
+	for (i = 0; i < n; ++i) {
+		double x = (norm() + 8) * (1u << TEST_KS_BITS);
+		++hist[x < 0 ? 0 : x >= TEST_KS_BINS ? TEST_KS_BINS - 1 :
+		       (size_t)x];
+	}
+	for (i = 0; i < TEST_KS_BINS; ++i) {
+		double p = Phi((double)(i + 1) / (1u << TEST_KS_BITS) - 8);
+		c += hist[i];
+		if (fabs(p - (double)c / n) > d)
+			d = fabs(p - (double)c / n);
+	}
+
+	TEST_ASSERT_MSG(d <= ks + 2.5 / sqrt(n), (
+		"\tKS distance %g exceeds the expected %g", d, ks));
+}
+
 static void
 test_norm(double (*norm)(void))
 {
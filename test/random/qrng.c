@@ -0,0 +1,158 @@
+#define RANDOM_H_IMPLEMENTATION
+#include <cauldron/random.h>
+#include <cauldron/test.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define N 4096
+
+static double pts[N][QRNG_SOBOL_MAX_DIM];
+
+/* every dimension of a (0,m,1)-sequence puts exactly one point in every
+ * interval [k/n,(k+1)/n) for n a power of two */
+static int
+is_stratified(size_t d)
+{
+	static unsigned char seen[N];
+	size_t n, i;
+	for (n = 2; n <= N; n *= 2) {
+		for (i = 0; i < n; ++i)
+			seen[i] = 0;
+		for (i = 0; i < n; ++i) {
+			size_t k = (size_t)(pts[i][d] * (double)n);
+			if (k >= n || seen[k]++)
+				return 0;
+		}
+	}
+	return 1;
+}
+
+/* the first two dimensions form a (0,2)-sequence: every elementary interval
+ * of area 1/n contains exactly one of the first n points */
+static int
+is_02(void)
+{
+	static unsigned char seen[N];
+	size_t n = N, a, b, i;
+	for (a = 1, b = N; b >= 1; a *= 2, b /= 2) {
+		for (i = 0; i < n; ++i)
+			seen[i] = 0;
+		for (i = 0; i < n; ++i) {
+			size_t x = (size_t)(pts[i][0] * (double)a);
+			size_t y = (size_t)(pts[i][1] * (double)b);
+			if (seen[x * b + y]++)
+				return 0;
+		}
+	}
+	return 1;
+}
+
+int
+main(void)
+{
+	static QrngSobol sobol, sobol2;
+	static QrngRd rd, rd2;
+	QrngHalton halton, halton2;
+	double x[QRNG_MAX_DIM], y[QRNG_MAX_DIM];
+	size_t i, d;
+
+	TEST_BEGIN(("qrng_sobol"));
+	qrng_sobol_init(&sobol, QRNG_SOBOL_MAX_DIM, 0);
+	for (i = 0; i < N; ++i)
+		qrng_sobol(&sobol, pts[i]);
+	TEST_ASSERT(pts[0][0] == 0.0  && pts[0][1] == 0.0);
+	TEST_ASSERT(pts[1][0] == 0.5  && pts[1][1] == 0.5);
+	TEST_ASSERT(pts[2][0] == 0.75 && pts[2][1] == 0.25);
+	TEST_ASSERT(pts[3][0] == 0.25 && pts[3][1] == 0.75);
+	for (d = 0; d < QRNG_SOBOL_MAX_DIM; ++d)
+		TEST_ASSERT_MSG(is_stratified(d), ("dim %u", (unsigned)d));
+	TEST_ASSERT(is_02());
+	TEST_END();
+
+	TEST_BEGIN(("qrng_sobol scrambled"));
+	qrng_sobol_init(&sobol, QRNG_SOBOL_MAX_DIM, 0x1234);
+	for (i = 0; i < N; ++i)
+		qrng_sobol(&sobol, pts[i]);
+	TEST_ASSERT(pts[0][0] != 0.0 && pts[0][0] != pts[0][1]);
+	for (d = 0; d < QRNG_SOBOL_MAX_DIM; ++d)
+		TEST_ASSERT_MSG(is_stratified(d), ("dim %u", (unsigned)d));
+	TEST_ASSERT(is_02());
+	TEST_END();
+
+	TEST_BEGIN(("qrng_sobol_skip"));
+	qrng_sobol_randomize(&sobol, QRNG_SOBOL_MAX_DIM);
+	sobol2 = sobol;
+	for (i = 0; i < 1000; ++i)
+		qrng_sobol(&sobol, x);
+	qrng_sobol_skip(&sobol2, 1000);
+	for (i = 0; i < 1000; ++i) {
+		qrng_sobol(&sobol, x);
+		qrng_sobol(&sobol2, y);
+		for (d = 0; d < QRNG_SOBOL_MAX_DIM; ++d)
+			TEST_ASSERT(x[d] == y[d]);
+		if (i % 7 == 0) {
+			qrng_sobol_skip(&sobol, (uint32_t)i);
+			qrng_sobol_skip(&sobol2, (uint32_t)i);
+		}
+	}
+	TEST_END();
+
+	TEST_BEGIN(("qrng_rd"));
+	qrng_rd_init(&rd, 1, 0);
+	qrng_rd(&rd, x);
+	TEST_ASSERT(x[0] == 0.5);
+	qrng_rd(&rd, x);
+	/* the golden ratio */
+	TEST_ASSERT(fabs(x[0] - fmod(0.5 + 2 / (1 + sqrt(5)), 1)) < 1e-12);
+	qrng_rd_init(&rd, 2, 0);
+	for (i = 0; i < N; ++i)
+		qrng_rd(&rd, pts[i]);
+	for (d = 0; d < 2; ++d) {
+		size_t cnt[16] = { 0 };
+		for (i = 0; i < N; ++i) {
+			TEST_ASSERT(pts[i][d] >= 0 && pts[i][d] < 1);
+			++cnt[(size_t)(pts[i][d] * 16)];
+		}
+		for (i = 0; i < 16; ++i)
+			TEST_ASSERT(cnt[i] >= N/16 - 2 && cnt[i] <= N/16 + 2);
+	}
+	TEST_END();
+
+	TEST_BEGIN(("qrng_rd_skip"));
+	qrng_rd_randomize(&rd, QRNG_MAX_DIM);
+	rd2 = rd;
+	for (i = 0; i < 1000; ++i)
+		qrng_rd(&rd, x);
+	qrng_rd_skip(&rd2, 1000);
+	for (i = 0; i < 100; ++i) {
+		qrng_rd(&rd, x);
+		qrng_rd(&rd2, y);
+		for (d = 0; d < QRNG_MAX_DIM; ++d)
+			TEST_ASSERT(x[d] == y[d]);
+	}
+	TEST_END();
+
+	TEST_BEGIN(("qrng_halton"));
+	qrng_halton_init(&halton, 2);
+	qrng_halton(&halton, x);
+	TEST_ASSERT(x[0] == 0 && x[1] == 0);
+	qrng_halton(&halton, x);
+	TEST_ASSERT(x[0] == 0.5 && fabs(x[1] - 1/3.0) < 1e-15);
+	qrng_halton(&halton, x);
+	TEST_ASSERT(x[0] == 0.25 && fabs(x[1] - 2/3.0) < 1e-15);
+	qrng_halton(&halton, x);
+	TEST_ASSERT(x[0] == 0.75 && fabs(x[1] - 1/9.0) < 1e-15);
+	qrng_halton_init(&halton, 32);
+	halton2 = halton;
+	for (i = 0; i < 1000; ++i)
+		qrng_halton(&halton, x);
+	qrng_halton_skip(&halton2, 1000);
+	qrng_halton(&halton, x);
+	qrng_halton(&halton2, y);
+	for (d = 0; d < 32; ++d)
+		TEST_ASSERT(x[d] == y[d] && x[d] >= 0 && x[d] < 1);
+	TEST_END();
+
+	return EXIT_SUCCESS;
+}
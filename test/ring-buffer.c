@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <sched.h>
+#include <pthread.h>
+
+#include <cauldron/ring-buffer.h>
+#include <cauldron/test.h>
+
+#define COUNT 200000
+#define THREADS 3
+#define BULK 7
+
+typedef struct { size_t id, x; } Item;
+
+static RbSpsc(size_t) spsc;
+static RbMpmc(Item) mpmc;
+static size_t thread_ids[THREADS] = { 0, 1, 2 };
+static size_t received;
+static size_t sums[THREADS];
+
+static void *
+spsc_producer(void *arg)
+{
+	size_t i, j, n, buf[BULK];
+	for (i = 0; i < COUNT; ) {
+		if (i & 1) {
+			i += rb_spsc_push(&spsc, &i);
+		} else {
+			for (j = 0; j < BULK; ++j)
+				buf[j] = i + j;
+			n = COUNT - i < BULK ? COUNT - i : BULK;
+			i += rb_spsc_push_n(&spsc, buf, n);
+		}
+		sched_yield();
+	}
+	return arg;
+}
+
+static void *
+mpmc_producer(void *arg)
+{
+	size_t id = *(size_t *)arg, i, j, n;
+	Item buf[BULK];
+	for (i = 0; i < COUNT; ) {
+		for (j = 0; j < BULK; ++j)
+			buf[j].id = id, buf[j].x = i + j;
+		n = COUNT - i < BULK ? COUNT - i : BULK;
+		n = id & 1 ? rb_mpmc_push(&mpmc, buf) :
+		             rb_mpmc_push_n(&mpmc, buf, n);
+		if (!n)
+			sched_yield();
+		i += n;
+	}
+	return arg;
+}
+
+/* every consumer checks, that it receives the items of each producer in
+ * order, and sums the values up */
+static void *
+mpmc_consumer(void *arg)
+{
+	size_t id = *(size_t *)arg, last[THREADS], i, n;
+	Item buf[BULK];
+	for (i = 0; i < THREADS; ++i)
+		last[i] = (size_t)-1;
+	while (__atomic_load_n(&received, __ATOMIC_RELAXED) < COUNT * THREADS) {
+		n = id & 1 ? rb_mpmc_pop(&mpmc, buf) :
+		             rb_mpmc_pop_n(&mpmc, buf, BULK);
+		if (!n)
+			sched_yield();
+		for (i = 0; i < n; ++i) {
+			if (last[buf[i].id] != (size_t)-1 &&
+			    buf[i].x <= last[buf[i].id])
+				return arg;
+			last[buf[i].id] = buf[i].x;
+			sums[id] += buf[i].x;
+		}
+		__atomic_fetch_add(&received, n, __ATOMIC_RELAXED);
+	}
+	return 0;
+}
+
+int
+main(void)
+{
+	size_t i, x, buf[64];
+
+	TEST_BEGIN(("RbSpsc single threaded"));
+	rb_spsc_init(&spsc, 10);
+	TEST_ASSERT(rb_cap(spsc) == 16);
+	TEST_ASSERT(!rb_spsc_pop(&spsc, &x));
+	for (i = 0; i < 64; ++i)
+		buf[i] = i;
+	TEST_ASSERT(rb_spsc_push_n(&spsc, buf, 10) == 10);
+	TEST_ASSERT(rb_spsc_pop_n(&spsc, buf + 32, 4) == 4);
+	TEST_ASSERT(buf[32] == 0 && buf[35] == 3);
+	/* wraps around */
+	TEST_ASSERT(rb_spsc_push_n(&spsc, buf + 10, 64) == 10);
+	TEST_ASSERT(!rb_spsc_push(&spsc, &x));
+	TEST_ASSERT(rb_spsc_pop_n(&spsc, buf + 32, 32) == 16);
+	for (i = 0; i < 16; ++i)
+		TEST_ASSERT(buf[32 + i] == i + 4);
+	rb_spsc_free(&spsc);
+	TEST_END();
+
+	TEST_BEGIN(("RbSpsc two threads"));
+	{
+		pthread_t t;
+		size_t expected = 0, n, j;
+		int ok = 1;
+		rb_spsc_init(&spsc, 16);
+		pthread_create(&t, 0, spsc_producer, 0);
+		while (expected < COUNT) {
+			n = expected & 1 ? rb_spsc_pop(&spsc, buf) :
+			                   rb_spsc_pop_n(&spsc, buf, 5);
+			for (j = 0; j < n; ++j)
+				ok &= buf[j] == expected++;
+			if (!n)
+				sched_yield();
+		}
+		pthread_join(t, 0);
+		TEST_ASSERT(ok);
+		TEST_ASSERT(!rb_spsc_pop(&spsc, &x));
+		rb_spsc_free(&spsc);
+	}
+	TEST_END();
+
+	TEST_BEGIN(("zero sized bulk operations"));
+	{
+		Item it;
+		rb_spsc_init(&spsc, 4);
+		rb_mpmc_init(&mpmc, 4);
+		TEST_ASSERT(rb_spsc_push_n(&spsc, buf, 0) == 0);
+		TEST_ASSERT(rb_spsc_pop_n(&spsc, buf, 0) == 0);
+		TEST_ASSERT(rb_mpmc_push_n(&mpmc, &it, 0) == 0);
+		TEST_ASSERT(rb_mpmc_pop_n(&mpmc, &it, 0) == 0);
+		TEST_ASSERT(!rb_mpmc_pop(&mpmc, &it));
+		rb_spsc_free(&spsc);
+		rb_mpmc_free(&mpmc);
+	}
+	TEST_END();
+
+	TEST_BEGIN(("RbMpmc %d producers and %d consumers", THREADS, THREADS));
+	{
+		pthread_t prod[THREADS], cons[THREADS];
+		size_t j, sum = 0;
+		void *ret;
+		Item it;
+		rb_mpmc_init(&mpmc, 64);
+		for (j = 0; j < THREADS; ++j) {
+			pthread_create(prod + j, 0, mpmc_producer, thread_ids + j);
+			pthread_create(cons + j, 0, mpmc_consumer, thread_ids + j);
+		}
+		for (j = 0; j < THREADS; ++j) {
+			pthread_join(prod[j], &ret);
+			pthread_join(cons[j], &ret);
+			TEST_ASSERT_MSG(!ret, ("consumer received items out of order"));
+			sum += sums[j];
+		}
+		TEST_ASSERT(received == COUNT * THREADS);
+		TEST_ASSERT(sum == THREADS * ((size_t)COUNT * (COUNT - 1) / 2));
+		TEST_ASSERT(!rb_mpmc_pop(&mpmc, &it));
+		rb_mpmc_free(&mpmc);
+	}
+	TEST_END();
+
+	return 0;
+}
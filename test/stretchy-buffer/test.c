@@ -1,5 +1,9 @@
+#define _GNU_SOURCE
 #define RANDOM_H_IMPLEMENTATION
 #include <cauldron/random.h>
+#define ARENA_ALLOCATOR_IMPLEMENT
+#include <cauldron/arena-allocator.h>
+#define sb_MMAP
 #include <cauldron/stretchy-buffer.h>
 #include <cauldron/test.h>
 
@@ -63,6 +67,137 @@ union S2 { struct { char x,y,z; } s; int u; };
 #define EQ(a,b) (a.s.x == b.s.x && a.s.y == b.s.y && a.s.z == b.s.z)
 #include "xtest.h"
 
+static void
+test_arena(void)
+{
+	aa_Arena arena = { 0 };
+	SbAllocator al = sb_aa_allocator(&arena);
+	Sb(int) a = { 0 }, b = { 0 };
+	int *first;
+	size_t i;
+
+	TEST_BEGIN(("Sb with aa_Arena"));
+	sb_setalloc(&a, &al);
+	sb_setalloc(&b, &al);
+	sb_push(&a, 0);
+	first = a.at;
+	/* a is the last allocation, so it grows in place */
+	for (i = 1; i < 1000; ++i)
+		sb_push(&a, (int)i);
+	TEST_ASSERT(a.at == first);
+	TEST_ASSERT(arena.blocks == arena.current);
+
+	/* b is now the last allocation, so a needs to be moved */
+	sb_push(&b, 42);
+	sb_setcap(&a, sb_cap(a) + 1);
+	TEST_ASSERT(a.at != first);
+	for (i = 0; i < 1000; ++i)
+		TEST_ASSERT(a.at[i] == (int)i);
+	TEST_ASSERT(b.at[0] == 42);
+
+	sb_shrink(&a);
+	TEST_ASSERT(sb_cap(a) == 1000);
+	for (i = 0; i < 1000; ++i)
+		TEST_ASSERT(a.at[i] == (int)i);
+	/* grows past the current block */
+	for (i = 1000; i < 100000; ++i)
+		sb_push(&a, (int)i);
+	for (i = 0; i < 100000; ++i)
+		TEST_ASSERT(a.at[i] == (int)i);
+
+	sb_free(&a);
+	sb_free(&b);
+	TEST_ASSERT(a._alloc == &al);
+	aa_free(&arena);
+	TEST_END();
+}
+
+static void
+test_growth(void)
+{
+	Sb(char) a = { 0 };
+	Sb(int) b = { 0 };
+	size_t i, caps[] = { 16, 24, 32, 48, 64, 96, 128, 192, 256 };
+
+	TEST_BEGIN(("Sb growth policy"));
+	for (i = 0; i < sizeof caps / sizeof *caps; ++i) {
+		sb_setlen(&a, sb_cap(a) + 1);
+		TEST_ASSERT(sb_cap(a) == caps[i]);
+	}
+	TEST_ASSERT(sb_grow_2x(48, 49) == 128);
+	TEST_ASSERT(sb_grow_2x(0, 1) == 16);
+	TEST_ASSERT((sb_grow_classes(sb_MMAP_MIN, 1) & (sb_PAGE_SIZE - 1)) == 0);
+
+	/* large buffers use mremap */
+	for (i = 0; i < 10000000; ++i)
+		sb_push(&b, (int)i);
+	for (i = 0; i < 10000000; ++i)
+		TEST_ASSERT(b.at[i] == (int)i);
+	sb_setlen(&b, 1000);
+	sb_shrink(&b);
+	TEST_ASSERT(sb_cap(b) == 1000);
+	for (i = 0; i < 1000; ++i)
+		TEST_ASSERT(b.at[i] == (int)i);
+	sb_free(&a);
+	sb_initcap(&a, sb_MMAP_MIN * 2);
+	sb_free(&a);
+	sb_free(&b);
+	TEST_END();
+}
+
+static void
+test_small(void)
+{
+	SbSmall(int, 8) a;
+	SbSmall(char, 3) b;
+	size_t i;
+
+	TEST_BEGIN(("SbSmall"));
+	sb_initsmall(&a);
+	TEST_ASSERT(sb_len(a) == 0 && sb_cap(a) == 8);
+	for (i = 0; i < 8; ++i)
+		sb_push(&a, (int)i);
+	TEST_ASSERT(sb_issmall(a) && sb_begin(a) == a._small);
+	sb_rm(&a, 0);
+	sb_ins(&a, 0, 0);
+	TEST_ASSERT(sb_issmall(a));
+
+	/* spills to the heap */
+	sb_push(&a, 8);
+	TEST_ASSERT(!sb_issmall(a) && sb_cap(a) > 8);
+	for (i = 9; i < 100; ++i)
+		sb_push(&a, (int)i);
+	TEST_ASSERT(sb_len(a) == 100);
+	for (i = 0; i < 100; ++i)
+		TEST_ASSERT(a.at[i] == (int)i);
+	sb_free(&a);
+
+	sb_initsmall(&a);
+	{
+		int arr[] = { 1, 2, 3 };
+		size_t cap;
+		sb_append(&a, arr, 3);
+		*sb_emplace(&a) = 4;
+		cap = sb_cap(a);
+		sb_popn(&a, 3);
+		sb_shrink(&a);
+		TEST_ASSERT(sb_cap(a) == cap);
+	}
+	TEST_ASSERT(sb_issmall(a) && sb_len(a) == 1 && *sb_last(a) == 1);
+	/* the freed inline slots are used again */
+	sb_push(&a, 2);
+	TEST_ASSERT(sb_issmall(a) && sb_len(a) == 2);
+	sb_free(&a);
+
+	/* sb_free without spilling doesn't free anything */
+	sb_initsmall(&b);
+	sb_push(&b, 'a');
+	sb_free(&b);
+	sb_push(&b, 'b');
+	TEST_ASSERT(!sb_issmall(b) && b.at[0] == 'b');
+	sb_free(&b);
+	TEST_END();
+}
 
 int
 main(void)
@@ -76,6 +211,9 @@ main(void)
 	test_ldouble();
 	test_s1();
 	test_s2();
+	test_arena();
+	test_growth();
+	test_small();
 	return 0;
 }
 
@@ -167,6 +167,35 @@ FUNC(void)
 		TEST_ASSERT(EQ(b.at[1], arr[1]));
 	}
 
+	{
+		T arr[4], *p;
+		for (i = 0; i < 4; ++i)
+			arr[i] = RAND(x);
+
+		sb_setlen(&a, 0);
+		sb_append(&a, arr, 2);
+		sb_append(&a, arr, 4);
+		TEST_ASSERT(sb_len(a) == 6);
+		for (i = 0; i < 6; ++i)
+			TEST_ASSERT(EQ(a.at[i], arr[i < 2 ? i : i - 2]));
+
+		sb_insert_range(&a, 1, arr + 2, 2);
+		i = sb_len(a);
+		sb_insert_range(&a, i, arr, 1);
+		TEST_ASSERT(sb_len(a) == 9);
+		TEST_ASSERT(EQ(a.at[0], arr[0]));
+		TEST_ASSERT(EQ(a.at[1], arr[2]));
+		TEST_ASSERT(EQ(a.at[2], arr[3]));
+		TEST_ASSERT(EQ(a.at[3], arr[1]));
+		TEST_ASSERT(EQ(a.at[8], arr[0]));
+
+		p = sb_extend_uninit(&a, 3);
+		TEST_ASSERT(sb_len(a) == 12 && p == a.at + 9);
+		p[0] = p[1] = p[2] = arr[3];
+		*sb_emplace(&a) = arr[1];
+		TEST_ASSERT(sb_len(a) == 13);
+		TEST_ASSERT(EQ(a.at[11], arr[3]) && EQ(a.at[12], arr[1]));
+	}
 
 	sb_free(&a);
 	sb_free(&b);
@@ -0,0 +1,68 @@
+#define _DEFAULT_SOURCE
+#define ARENA_ALLOCATOR_IMPLEMENT
+#include <cauldron/arena-allocator.h>
+#include <cauldron/bench.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define COUNT (1024*64)
+#define ROUNDS 16
+#define SAMPLES 64
+
+typedef struct Node { struct Node *next; size_t val[3]; } Node;
+
+static Node *live[COUNT];
+
+/* Allocates COUNT nodes and then repeatedly frees and reallocates a
+ * pseudorandom half of them, which models a node based data structure with
+ * churn. */
+#define BENCH_CHURN(name, alloc, dealloc, init, fini) \
+	BENCH(name, 4, SAMPLES) { \
+		size_t i, j; \
+		init; \
+		for (i = 0; i < COUNT; ++i) \
+			live[i] = (Node *)(alloc); \
+		for (j = 0; j < ROUNDS; ++j) { \
+			for (i = 0; i < COUNT; ++i) \
+				if (bench_hash64(i + j * COUNT) & 1) \
+					dealloc(live[i]), live[i] = 0; \
+			for (i = 0; i < COUNT; ++i) \
+				if (!live[i]) \
+					live[i] = (Node *)(alloc); \
+			BENCH_CLOBBER(); \
+		} \
+		for (i = 0; i < COUNT; ++i) \
+			dealloc(live[i]); \
+		fini; \
+	}
+
+static aa_Arena arena;
+static aa_Pool pool;
+static aa_PoolCache cache;
+
+static void pool_dealloc(void *p) { aa_pool_dealloc(&pool, p); }
+static void cache_dealloc(void *p) { aa_pool_cache_dealloc(&cache, p); }
+static void arena_dealloc(void *p) { (void)p; }
+
+int
+main(void)
+{
+	puts("fixed size allocation with churn:");
+	BENCH_CHURN("malloc/free", malloc(sizeof(Node)), free, (void)0, (void)0);
+	BENCH_CHURN("aa_Pool", aa_pool_alloc(&pool), pool_dealloc,
+	            aa_pool_init(&pool, &arena, sizeof(Node), 0),
+	            aa_dealloc(&arena));
+	BENCH_CHURN("aa_PoolCache", aa_pool_cache_alloc(&cache), cache_dealloc,
+	            (aa_pool_init(&pool, &arena, sizeof(Node), 0),
+	             aa_pool_cache_init(&cache, &pool)),
+	            aa_dealloc(&arena));
+	/* never reuses memory, only for reference */
+	BENCH_CHURN("aa_alloc", aa_alloc(&arena, sizeof(Node)), arena_dealloc,
+	            (void)0, aa_dealloc(&arena));
+	bench_done();
+
+	aa_free(&arena);
+	bench_free();
+	return 0;
+}
@@ -0,0 +1,74 @@
+#include <cauldron/hash-map.h>
+#include <cauldron/bench.h>
+
+#include <stdio.h>
+#include <unordered_map>
+
+#define COUNT (1024*256)
+#define SAMPLES 16
+
+static uint64_t keys[COUNT];
+
+typedef Hm(uint64_t, uint64_t) HmU64;
+typedef std::unordered_map<uint64_t, uint64_t> StdU64;
+
+/* Inserts COUNT random 64 bit keys into an empty map, then looks up all of
+ * them, the same number of absent keys, and finally erases them again.
+ * The insert benchmark includes freeing the map, so both maps start every
+ * sample without any allocated storage. */
+#define BENCH_MAP(name, Map, put, get, del, fini) \
+	do { \
+		Map; \
+		size_t i; \
+		uint64_t sum = 0; \
+		BENCH(name ": insert", 2, SAMPLES) { \
+			for (i = 0; i < COUNT; ++i) \
+				put(keys[i], i); \
+			BENCH_CLOBBER(); \
+			fini; \
+		} \
+		for (i = 0; i < COUNT; ++i) \
+			put(keys[i], i); \
+		BENCH(name ": lookup hit", 2, SAMPLES) { \
+			for (i = 0; i < COUNT; ++i) \
+				sum += get(keys[i]); \
+			BENCH_VOLATILE(sum); \
+		} \
+		BENCH(name ": lookup miss", 2, SAMPLES) { \
+			for (i = 0; i < COUNT; ++i) \
+				sum += get(~keys[i]); \
+			BENCH_VOLATILE(sum); \
+		} \
+		BENCH(name ": erase", 0, 1) { \
+			for (i = 0; i < COUNT; ++i) \
+				del(keys[i]); \
+			BENCH_CLOBBER(); \
+		} \
+		fini; \
+	} while (0)
+
+#define HM_PUT(k,v) hm_put(&hm, (k), (v))
+#define HM_GET(k) (p = hm_get(&hm, (k)), p ? *p : 0)
+#define HM_DEL(k) hm_del(&hm, (k))
+
+#define STD_PUT(k,v) (um[(k)] = (v))
+#define STD_GET(k) (it = um.find(k), it != um.end() ? it->second : 0)
+#define STD_DEL(k) um.erase(k)
+
+int
+main(void)
+{
+	size_t i;
+	for (i = 0; i < COUNT; ++i)
+		keys[i] = bench_hash64(i);
+
+	puts("uint64_t -> uint64_t:");
+	BENCH_MAP("Hm", HmU64 hm = HmU64(); uint64_t *p,
+	          HM_PUT, HM_GET, HM_DEL, hm_free(&hm));
+	BENCH_MAP("std::unordered_map", StdU64 um; StdU64::iterator it,
+	          STD_PUT, STD_GET, STD_DEL, StdU64().swap(um));
+	bench_done();
+
+	bench_free();
+	return 0;
+}
@@ -0,0 +1,78 @@
+#include <cauldron/radix-sort.h>
+#include <cauldron/bench.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef COUNT
+#define COUNT (1000*1000*10)
+#endif
+#define SAMPLES 4
+
+static int
+cmp_u32(void const *lhs, void const *rhs)
+{
+	uint32_t l = *(uint32_t const *)lhs, r = *(uint32_t const *)rhs;
+	return l < r ? -1 : l > r;
+}
+
+static int
+cmp_u64(void const *lhs, void const *rhs)
+{
+	uint64_t l = *(uint64_t const *)lhs, r = *(uint64_t const *)rhs;
+	return l < r ? -1 : l > r;
+}
+
+static uint32_t *a32;
+static uint64_t *a64, *tmp;
+static RsKv32 *kv32;
+
+static void
+fill(size_t seed)
+{
+	size_t i;
+	for (i = 0; i < COUNT; ++i) {
+		a64[i] = bench_hash64(i + seed * COUNT);
+		a32[i] = (uint32_t)a64[i];
+		kv32[i].key = a32[i];
+		kv32[i].val = (uint32_t)i;
+	}
+}
+
+/* the input is refilled before every sample, which is included in the time */
+#define BENCH_SORT(name, sort) \
+	do { \
+		size_t seed = 0; \
+		BENCH(name, 1, SAMPLES) { \
+			fill(++seed); \
+			sort; \
+			BENCH_CLOBBER(); \
+		} \
+	} while (0)
+
+int
+main(void)
+{
+	a32 = (uint32_t *)malloc(COUNT * sizeof *a32);
+	a64 = (uint64_t *)malloc(COUNT * sizeof *a64);
+	tmp = (uint64_t *)malloc(COUNT * sizeof *tmp);
+	kv32 = (RsKv32 *)malloc(COUNT * sizeof *kv32);
+	if (!a32 || !a64 || !tmp || !kv32)
+		return EXIT_FAILURE;
+
+	printf("sorting %d elements, %d threads:\n", COUNT, RS_THREADS);
+	BENCH_SORT("fill only", (void)0);
+	BENCH_SORT("qsort uint32_t", qsort(a32, COUNT, sizeof *a32, cmp_u32));
+	BENCH_SORT("rs_u32", rs_u32(a32, (uint32_t *)(void *)tmp, COUNT));
+	BENCH_SORT("qsort uint64_t", qsort(a64, COUNT, sizeof *a64, cmp_u64));
+	BENCH_SORT("rs_u64", rs_u64(a64, tmp, COUNT));
+	BENCH_SORT("rs_kv32", rs_kv32(kv32, (RsKv32 *)(void *)tmp, COUNT));
+	bench_done();
+
+	free(a32);
+	free(a64);
+	free(tmp);
+	free(kv32);
+	bench_free();
+	return 0;
+}
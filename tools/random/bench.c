@@ -1,5 +1,6 @@
 #define RANDOM_H_IMPLEMENTATION
 #include <cauldron/random.h>
+#include <cauldron/random-ziggurat.h>
 #include <cauldron/bench.h>
 
 #include <stdio.h>
@@ -20,6 +21,7 @@
 			ftype x, y; \
 			size_t i, c; \
 			double pi; \
+			bench_elements(COUNT * 2.0); \
 			for (i = c = 0; i < COUNT; ++i) { \
 				x = next * (ftype)1.0 / max; \
 				y = next * (ftype)1.0 / max; \
@@ -90,6 +92,7 @@ bench_rng_64(void)
 		BENCH(name, 8, SAMPLES) { \
 			ftype x, y; \
 			size_t i, c; \
+			bench_elements(COUNT * 2.0); \
 			for (i = c = 0; i < COUNT; ++i) { \
 				x = next; \
 				y = next; \
@@ -118,8 +121,14 @@ bench_normal(void)
 
 	puts("normal distribution using prng64_romu_duo_jr");
 	BENCH_NORM("dist_normalf_fast", dist_normalf_fast(NORM_NEXT(&rng)));
+	BENCH_NORM("dist_normalf_popcnt(1)",
+	           dist_normalf_popcnt(1, NORM_NEXT, &rng));
+	BENCH_NORM("dist_normalf_popcnt(4)",
+	           dist_normalf_popcnt(4, NORM_NEXT, &rng));
 	BENCH_NORM("dist_normal", dist_normal(NORM_NEXT, &rng));
 	BENCH_NORM("dist_normal_zig", dist_normal_zig(&zig, NORM_NEXT, &rng));
+	BENCH_NORM("dist_normal_zig_static",
+	           dist_normal_zig_static(NORM_NEXT, &rng));
 
 	bench_done();
 	putchar('\n');
@@ -134,11 +143,47 @@ bench_normalf(void)
 	puts("normal distribution using prng32_romu_trio");
 	BENCH_NORMF("dist_normalf", dist_normalf(NORMF_NEXT, &rng));
 	BENCH_NORMF("dist_normalf_zig", dist_normalf_zig(&zig, NORMF_NEXT, &rng));
+	BENCH_NORMF("dist_normalf_zig_static",
+	            dist_normalf_zig_static(NORMF_NEXT, &rng));
 
 	bench_done();
 	putchar('\n');
 }
 
+static void
+bench_mvnormal(void)
+{
+	enum { DIM = 64, N = 1024 };
+	static double cov[DIM*DIM], x[DIM*N];
+	size_t i, j;
+	DistNormalZig zig;
+	DistMvNormal mv;
+	PRNG64RomuDuo rng;
+
+	dist_normal_zig_init(&zig);
+	prng64_romu_duo_randomize(&rng);
+	for (i = 0; i < DIM; ++i)
+		for (j = 0; j < DIM; ++j)
+			cov[i*DIM + j] = i == j ? 2 : 1;
+	if (!dist_mvnormal_init(&mv, 0, cov, DIM))
+		return;
+
+	puts("64-dimensional multivariate normal distribution");
+	BENCH("dist_normal_zig * DIM", 8, SAMPLES) {
+		for (i = 0; i < DIM*N; ++i)
+			x[i] = dist_normal_zig(&zig, NORM_NEXT, &rng);
+		BENCH_CLOBBER();
+	}
+	BENCH("dist_mvnormal", 8, SAMPLES) {
+		dist_mvnormal(&mv, x, N, &zig, NORM_NEXT, &rng);
+		BENCH_CLOBBER();
+	}
+
+	bench_done();
+	putchar('\n');
+	dist_mvnormal_free(&mv);
+}
+
 int
 main(void)
 {
@@ -150,6 +195,7 @@ main(void)
 	bench_rng_64();
 	bench_normal();
 	bench_normalf();
+	bench_mvnormal();
 
 	bench_free();
 	return 0;
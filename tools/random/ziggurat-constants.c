@@ -1,6 +1,8 @@
 #include <float.h>
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #define M_SQRTPI_OVER_SQRT2 1.253314137315500251207882642405522627L
 #define M_1_OVER_SQRT2 0.707106781186547524400844362104849039L
@@ -10,13 +12,9 @@
 #define ziggurat_f_int_x_to_inf(x) \
 	-(M_SQRTPI_OVER_SQRT2 * (erfl(x * M_1_OVER_SQRT2) - 1))
 
-int
-main(void)
+static void
+ziggurat_solve(unsigned count, long double *outR, long double *outArea)
 {
-	unsigned count = 0;
-	printf("#define ZIGGURAT_COUNT ");
-	scanf("%u", &count);
-
 	long double min = 0, max = 10, pmin, pmax;
 	long double area, R;
 	do {
@@ -39,8 +37,160 @@ main(void)
 			max = R;
 	} while (pmin < R && R < pmax);
 
+	*outR = R;
+	*outArea = area;
+}
+
+/* Prints the table in the same layout dist_normal(f)_zig_init computes it,
+ * but evaluated in long double precision. */
+static void
+ziggurat_table(unsigned count, int isfloat, int first)
+{
+	long double R, area, f, x;
+	unsigned i;
+	char const *sfx = isfloat ? "f" : "";
+	/* enough digits to round trip a float/double */
+	int digits = isfloat ? 9 : 17;
+
+	ziggurat_solve(count, &R, &area);
+
+	printf("#%s DIST_NORMAL%s_ZIG_COUNT == %u\n", first ? "if" : "elif",
+	       isfloat ? "F" : "", count);
+	printf("# define DIST_NORMAL%s_ZIG_TABLE_R     %.*Lg%s\n",
+	       isfloat ? "F" : "", DECIMAL_DIG, R, sfx);
+	printf("# define DIST_NORMAL%s_ZIG_TABLE_AREA  %.*Lg%s\n",
+	       isfloat ? "F" : "", DECIMAL_DIG, area, sfx);
+	printf("static DistNormal%sZig const distNormal%sZigStatic = {{\n",
+	       isfloat ? "f" : "", isfloat ? "f" : "");
+
+	f = ziggurat_f(R);
+	x = area / f;
+	for (i = 0; i <= count; ++i) {
+		if (i == 1) {
+			x = R;
+		} else if (i == count) {
+			x = 0;
+		} else if (i > 1) {
+			long double xx = area / x + f;
+			x = ziggurat_f_inv(xx);
+			f = xx;
+		}
+		printf("%s%.*Lg%s%s,%s", i % 4 == 0 ? "\t" : "", digits, x,
+		       x == 0 ? ".0" : "", sfx,
+		       i % 4 == 3 || i == count ? "\n" : " ");
+	}
+	puts("}};");
+}
+
+int
+main(int argc, char **argv)
+{
+	static unsigned const countf[] = { 32, 64, 128 };
+	static unsigned const count[] = { 128, 256, 512, 1024 };
+	long double R, area;
+	unsigned n = 0;
+	size_t i;
+
+	/* "-t" prints cauldron/random-ziggurat.h */
+	if (argc > 1 && strcmp(argv[1], "-t") == 0) {
+		puts("/* random-ziggurat.h -- precomputed ziggurat tables for "
+		     "random.h");
+		puts(" * Generated by tools/random/ziggurat-constants.c -t");
+		puts(" *");
+		puts(" * Include this after random.h to use dist_normal(f)_zig_static,"
+		     " which");
+		puts(" * doesn't need a DistNormal(f)Zig object or a call to "
+		     "dist_normal(f)_zig_init.");
+		puts(" * Tables are provided for DIST_NORMALF_ZIG_COUNT "
+		     "32/64/128 and");
+		puts(" * DIST_NORMAL_ZIG_COUNT 128/256/512/1024, DIST_NORMAL(F)_ZIG_R"
+		     " and");
+		puts(" * DIST_NORMAL(F)_ZIG_AREA must match DIST_NORMAL(F)_ZIG_TABLE_R"
+		     " and");
+		puts(" * DIST_NORMAL(F)_ZIG_TABLE_AREA of the selected table. "
+		     "This is checked at");
+		puts(" * compile time with C11 or C++11, and by an assertion in "
+		     "the functions");
+		puts(" * below otherwise. */");
+		puts("");
+		puts("#ifndef RANDOM_ZIGGURAT_H_INCLUDED");
+		puts("");
+		puts("#include <assert.h>");
+		puts("");
+		for (i = 0; i < sizeof countf / sizeof *countf; ++i)
+			ziggurat_table(countf[i], 1, i == 0);
+		puts("#else");
+		puts("# error random-ziggurat.h: no table for "
+		     "DIST_NORMALF_ZIG_COUNT");
+		puts("#endif");
+		puts("");
+		for (i = 0; i < sizeof count / sizeof *count; ++i)
+			ziggurat_table(count[i], 0, i == 0);
+		puts("#else");
+		puts("# error random-ziggurat.h: no table for "
+		     "DIST_NORMAL_ZIG_COUNT");
+		puts("#endif");
+		puts("");
+		puts("#define DIST_NORMAL_ZIG__EQ(a, b) \\");
+		puts("\t((a) - (b) <= (b) * 1e-6 && (b) - (a) <= (b) * 1e-6)");
+		for (i = 0; i < 2; ++i) {
+			char const *s = i ? "" : "F";
+			printf("#define DIST_NORMAL%s_ZIG_TABLE_OK \\\n", s);
+			printf("\t(DIST_NORMAL_ZIG__EQ(DIST_NORMAL%s_ZIG_R, "
+			       "DIST_NORMAL%s_ZIG_TABLE_R) && \\\n", s, s);
+			printf("\t DIST_NORMAL_ZIG__EQ(DIST_NORMAL%s_ZIG_AREA, "
+			       "DIST_NORMAL%s_ZIG_TABLE_AREA))\n", s, s);
+		}
+		puts("");
+		puts("#if defined(__cplusplus) && __cplusplus >= 201103L");
+		puts("static_assert(DIST_NORMALF_ZIG_TABLE_OK, \"random-ziggurat.h: \"");
+		puts("\t\"DIST_NORMALF_ZIG_R/AREA don't match the table\");");
+		puts("static_assert(DIST_NORMAL_ZIG_TABLE_OK, \"random-ziggurat.h: \"");
+		puts("\t\"DIST_NORMAL_ZIG_R/AREA don't match the table\");");
+		puts("#elif defined(__GNUC__) && defined(__STDC_VERSION__) && "
+		     "__STDC_VERSION__ >= 201112L");
+		puts("/* floating point comparisons are an extension in "
+		     "_Static_assert */");
+		puts("__extension__ _Static_assert(DIST_NORMALF_ZIG_TABLE_OK, "
+		     "\"random-ziggurat.h: \"");
+		puts("\t\"DIST_NORMALF_ZIG_R/AREA don't match the table\");");
+		puts("__extension__ _Static_assert(DIST_NORMAL_ZIG_TABLE_OK, "
+		     "\"random-ziggurat.h: \"");
+		puts("\t\"DIST_NORMAL_ZIG_R/AREA don't match the table\");");
+		puts("#endif");
+		puts("");
+		puts("static inline float");
+		puts("dist_normalf_zig_static(uint32_t (*rand32)(void*), "
+		     "void *rng)");
+		puts("{");
+		puts("\tassert(DIST_NORMALF_ZIG_TABLE_OK);");
+		puts("\treturn dist_normalf_zig(&distNormalfZigStatic, "
+		     "rand32, rng);");
+		puts("}");
+		puts("");
+		puts("static inline double");
+		puts("dist_normal_zig_static(uint64_t (*rand64)(void*), "
+		     "void *rng)");
+		puts("{");
+		puts("\tassert(DIST_NORMAL_ZIG_TABLE_OK);");
+		puts("\treturn dist_normal_zig(&distNormalZigStatic, "
+		     "rand64, rng);");
+		puts("}");
+		puts("");
+		puts("#define RANDOM_ZIGGURAT_H_INCLUDED");
+		puts("#endif");
+		return 0;
+	}
+
+	printf("#define ZIGGURAT_COUNT ");
+	if (scanf("%u", &n) != 1)
+		return EXIT_FAILURE;
+
+	ziggurat_solve(n, &R, &area);
+
 	printf("#define ZIGGURAT_R     %.*Lg\n", DECIMAL_DIG, R);
 	printf("#define ZIGGURAT_AREA  %.*Lg\n", DECIMAL_DIG, area);
+	return 0;
 }
 
 /*
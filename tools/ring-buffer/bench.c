@@ -0,0 +1,189 @@
+#define _GNU_SOURCE
+#include <cauldron/ring-buffer.h>
+#include <cauldron/bench.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+
+#define COUNT (1024*1024)
+#define PINGS (1024*16)
+#define CAP 1024
+#define BULK 32
+#define SAMPLES 8
+
+/* spin a few times before giving up the time slice */
+static inline size_t
+backoff(size_t n, unsigned *spin)
+{
+	if (n)
+		*spin = 0;
+	else if (++*spin > 64)
+		sched_yield(), *spin = 0;
+	return n;
+}
+
+#define WAIT(cond) \
+	do { \
+		unsigned spin = 0; \
+		while (!backoff((cond), &spin)); \
+	} while (0)
+
+static RbSpsc(uint64_t) spsc, spsc_back;
+static RbMpmc(uint64_t) mpmc, mpmc_back;
+static size_t bulk, producers;
+
+/*
+ * Throughput: producers push COUNT items in total, which the main thread pops.
+ */
+
+static void *
+spsc_producer(void *arg)
+{
+	uint64_t buf[BULK] = { 0 };
+	size_t i;
+	unsigned spin = 0;
+	for (i = 0; i < COUNT; )
+		i += backoff(bulk > 1 ? rb_spsc_push_n(&spsc, buf, bulk) :
+		                        rb_spsc_push(&spsc, buf), &spin);
+	return arg;
+}
+
+static void *
+mpmc_producer(void *arg)
+{
+	uint64_t buf[BULK] = { 0 };
+	size_t i;
+	unsigned spin = 0;
+	for (i = 0; i < COUNT / producers; )
+		i += backoff(bulk > 1 ? rb_mpmc_push_n(&mpmc, buf, bulk) :
+		                        rb_mpmc_push(&mpmc, buf), &spin);
+	return arg;
+}
+
+static void
+throughput(int isspsc)
+{
+	pthread_t t[4];
+	uint64_t buf[BULK];
+	size_t i, j;
+	unsigned spin = 0;
+	for (j = 0; j < producers; ++j)
+		pthread_create(t + j, 0, isspsc ? spsc_producer : mpmc_producer, 0);
+	for (i = 0; i < COUNT; ) {
+		if (isspsc)
+			i += backoff(bulk > 1 ? rb_spsc_pop_n(&spsc, buf, bulk) :
+			                        rb_spsc_pop(&spsc, buf), &spin);
+		else
+			i += backoff(bulk > 1 ? rb_mpmc_pop_n(&mpmc, buf, bulk) :
+			                        rb_mpmc_pop(&mpmc, buf), &spin);
+		BENCH_CLOBBER();
+	}
+	for (j = 0; j < producers; ++j)
+		pthread_join(t[j], 0);
+}
+
+/*
+ * Latency: one item is passed back and forth PINGS times.
+ */
+
+static void *
+spsc_ponger(void *arg)
+{
+	uint64_t x;
+	size_t i;
+	for (i = 0; i < PINGS; ++i) {
+		WAIT(rb_spsc_pop(&spsc, &x));
+		++x;
+		WAIT(rb_spsc_push(&spsc_back, &x));
+	}
+	return arg;
+}
+
+static void *
+mpmc_ponger(void *arg)
+{
+	uint64_t x;
+	size_t i;
+	for (i = 0; i < PINGS; ++i) {
+		WAIT(rb_mpmc_pop(&mpmc, &x));
+		++x;
+		WAIT(rb_mpmc_push(&mpmc_back, &x));
+	}
+	return arg;
+}
+
+static void
+latency(int isspsc)
+{
+	pthread_t t;
+	uint64_t x = 0;
+	size_t i;
+	pthread_create(&t, 0, isspsc ? spsc_ponger : mpmc_ponger, 0);
+	for (i = 0; i < PINGS; ++i) {
+		if (isspsc) {
+			WAIT(rb_spsc_push(&spsc, &x));
+			WAIT(rb_spsc_pop(&spsc_back, &x));
+		} else {
+			WAIT(rb_mpmc_push(&mpmc, &x));
+			WAIT(rb_mpmc_pop(&mpmc_back, &x));
+		}
+	}
+	pthread_join(t, 0);
+}
+
+/*
+ * Contention: every thread pushes and pops PINGS items on the same queue.
+ */
+
+static void
+contend(void *arg, size_t thread)
+{
+	uint64_t x = thread;
+	size_t i;
+	(void)arg;
+	for (i = 0; i < PINGS; ++i) {
+		WAIT(rb_mpmc_push(&mpmc, &x));
+		WAIT(rb_mpmc_pop(&mpmc, &x));
+	}
+}
+
+int
+main(void)
+{
+	rb_spsc_init(&spsc, CAP);
+	rb_spsc_init(&spsc_back, CAP);
+	rb_mpmc_init(&mpmc, CAP);
+	rb_mpmc_init(&mpmc_back, CAP);
+
+	printf("throughput, %d uint64_t:\n", COUNT);
+	producers = 1;
+	bulk = 1;
+	BENCH("RbSpsc", 1, SAMPLES) throughput(1);
+	BENCH("RbMpmc 1 producer", 1, SAMPLES) throughput(0);
+	producers = 4;
+	BENCH("RbMpmc 4 producers", 1, SAMPLES) throughput(0);
+	producers = 1;
+	bulk = BULK;
+	BENCH("RbSpsc bulk", 1, SAMPLES) throughput(1);
+	BENCH("RbMpmc 1 producer bulk", 1, SAMPLES) throughput(0);
+	producers = 4;
+	BENCH("RbMpmc 4 producers bulk", 1, SAMPLES) throughput(0);
+	bench_done();
+
+	printf("\nlatency, %d round trips:\n", PINGS);
+	BENCH("RbSpsc", 1, SAMPLES) latency(1);
+	BENCH("RbMpmc", 1, SAMPLES) latency(0);
+	bench_done();
+
+	printf("\ncontention, %d push/pop pairs per thread:\n", PINGS);
+	bench_parallel_sweep("RbMpmc", 8, 1, SAMPLES, contend, 0);
+	bench_done();
+
+	rb_spsc_free(&spsc);
+	rb_spsc_free(&spsc_back);
+	rb_mpmc_free(&mpmc);
+	rb_mpmc_free(&mpmc_back);
+	bench_free();
+	return 0;
+}